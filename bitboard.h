@@ -0,0 +1,111 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+
+/*
+ * 8x8 OctaFlip board packed into 64-bit masks.
+ * bit (r * 8 + c) is cell (r, c); row 0 is the low byte.
+ * n_* 카운터는 bb_move 가 flip 하면서 같이 갱신한다 (popcount 재계산 불필요).
+ * key 는 돌/장애물 배치 + 둘 차례(side)의 Zobrist 해시, 역시 bb_move/bb_pass 가 갱신.
+ */
+typedef struct {
+    uint64_t red;
+    uint64_t blue;
+    uint64_t obstacle;
+    uint8_t  n_red;
+    uint8_t  n_blue;
+    uint8_t  n_empty;
+    uint8_t  n_obstacle;
+    uint8_t  side;        // 둘 차례: 0 = 'R', 1 = 'B'
+    uint64_t key;
+} BitBoard;
+
+#define BB_SQ(r, c)   ((r) * 8 + (c))
+#define BB_ROW(sq)    ((sq) >> 3)
+#define BB_COL(sq)    ((sq) & 7)
+#define BB_BIT(sq)    (1ULL << (sq))
+
+#define BB_ALL        0xFFFFFFFFFFFFFFFFULL
+#define BB_FILE_A     0x0101010101010101ULL
+#define BB_FILE_B     (BB_FILE_A << 1)
+#define BB_FILE_G     (BB_FILE_A << 6)
+#define BB_FILE_H     (BB_FILE_A << 7)
+
+static inline int bb_popcount(uint64_t b) { return __builtin_popcountll(b); }
+static inline int bb_lsb(uint64_t b)      { return __builtin_ctzll(b); }
+
+static inline char bb_side(const BitBoard *bb) { return bb->side ? 'B' : 'R'; }
+
+static inline uint64_t bb_empty(const BitBoard *bb) {
+    return ~(bb->red | bb->blue | bb->obstacle);
+}
+static inline uint64_t bb_own(const BitBoard *bb, char color) {
+    return color == 'R' ? bb->red : bb->blue;
+}
+static inline uint64_t bb_opp(const BitBoard *bb, char color) {
+    return color == 'R' ? bb->blue : bb->red;
+}
+
+// 한 칸(8방향) 이웃: clone 목적지이자 flip 영역
+static inline uint64_t bb_adjacent(uint64_t b) {
+    uint64_t e = (b << 1) & ~BB_FILE_A;
+    uint64_t w = (b >> 1) & ~BB_FILE_H;
+    uint64_t h = b | e | w;
+    return (h << 8) | (h >> 8) | e | w;
+}
+
+// 두 칸(8방향) 떨어진 칸: jump 목적지
+static inline uint64_t bb_jump_targets(uint64_t b) {
+    uint64_t e = (b << 2) & ~(BB_FILE_A | BB_FILE_B);
+    uint64_t w = (b >> 2) & ~(BB_FILE_G | BB_FILE_H);
+    uint64_t h = b | e | w;
+    return (h << 16) | (h >> 16) | e | w;
+}
+
+// -----------------------------------------------------------------------------
+//  칸별 마스크 테이블 (상수식으로 컴파일 타임에 채워짐, 런타임 초기화/경계검사 없음)
+// -----------------------------------------------------------------------------
+#define BB_ON(r, c)  (((unsigned)(r) < 8 && (unsigned)(c) < 8) \
+                      ? (1ULL << (((r) * 8 + (c)) & 63)) : 0ULL)
+
+#define BB_ADJ_AT(r, c)  (BB_ON((r)-1, (c)-1) | BB_ON((r)-1, (c)) | BB_ON((r)-1, (c)+1) | \
+                          BB_ON((r),   (c)-1) |                     BB_ON((r),   (c)+1) | \
+                          BB_ON((r)+1, (c)-1) | BB_ON((r)+1, (c)) | BB_ON((r)+1, (c)+1))
+#define BB_JUMP_AT(r, c) (BB_ON((r)-2, (c)-2) | BB_ON((r)-2, (c)) | BB_ON((r)-2, (c)+2) | \
+                          BB_ON((r),   (c)-2) |                     BB_ON((r),   (c)+2) | \
+                          BB_ON((r)+2, (c)-2) | BB_ON((r)+2, (c)) | BB_ON((r)+2, (c)+2))
+
+#define BB_ROW8(M, r)  M(r, 0), M(r, 1), M(r, 2), M(r, 3), \
+                       M(r, 4), M(r, 5), M(r, 6), M(r, 7)
+#define BB_TABLE64(M)  { BB_ROW8(M, 0), BB_ROW8(M, 1), BB_ROW8(M, 2), BB_ROW8(M, 3), \
+                         BB_ROW8(M, 4), BB_ROW8(M, 5), BB_ROW8(M, 6), BB_ROW8(M, 7) }
+
+// sq 의 8방향 인접 칸 (clone 목적지)
+static const uint64_t BB_ADJ_MASK[64]  = BB_TABLE64(BB_ADJ_AT);
+// sq 에서 두 칸 떨어진 칸 (jump 목적지)
+static const uint64_t BB_JUMP_MASK[64] = BB_TABLE64(BB_JUMP_AT);
+// sq 에 돌을 놓았을 때 flip 되는 영역 == 인접 칸
+#define BB_FLIP_MASK BB_ADJ_MASK
+
+// -----------------------------------------------------------------------------
+//  Zobrist 키 (splitmix64 상수식, 역시 컴파일 타임 테이블)
+// -----------------------------------------------------------------------------
+#define ZB_MIX1(z)  (((z) ^ ((z) >> 30)) * 0xBF58476D1CE4E5B9ULL)
+#define ZB_MIX2(z)  (((z) ^ ((z) >> 27)) * 0x94D049BB133111EBULL)
+#define ZB_MIX3(z)  ((z) ^ ((z) >> 31))
+#define ZB_HASH(i)  ZB_MIX3(ZB_MIX2(ZB_MIX1(((uint64_t)(i) + 1) * 0x9E3779B97F4A7C15ULL)))
+
+#define ZB_RED_AT(r, c)   ZB_HASH(BB_SQ(r, c))
+#define ZB_BLUE_AT(r, c)  ZB_HASH(64 + BB_SQ(r, c))
+#define ZB_OBS_AT(r, c)   ZB_HASH(128 + BB_SQ(r, c))
+#define ZB_FLIP_AT(r, c)  (ZB_RED_AT(r, c) ^ ZB_BLUE_AT(r, c))
+
+static const uint64_t ZOBRIST_RED[64]      = BB_TABLE64(ZB_RED_AT);
+static const uint64_t ZOBRIST_BLUE[64]     = BB_TABLE64(ZB_BLUE_AT);
+static const uint64_t ZOBRIST_OBSTACLE[64] = BB_TABLE64(ZB_OBS_AT);
+// R <-> B 로 뒤집힐 때 한 번에 XOR
+static const uint64_t ZOBRIST_FLIP[64]     = BB_TABLE64(ZB_FLIP_AT);
+#define ZOBRIST_SIDE  ZB_HASH(192)   // 'B' 차례일 때 XOR
+
+#endif // BITBOARD_H
@@ -0,0 +1,113 @@
+#include "../include/book.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static void *book_map = NULL;
+static size_t book_bytes = 0;
+static const BookEntry *book_entries = NULL;
+static size_t book_count = 0;
+
+// 읽기 전용 mmap, 페이지는 처음 찾을 때 올라온다 (시작 시 로딩 없음)
+int book_open(const char *path) {
+    book_close();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("open book");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(BookHeader)) {
+        fprintf(stderr, "Book file too small: %s\n", path);
+        close(fd);
+        return -1;
+    }
+    void *mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        perror("mmap book");
+        return -1;
+    }
+
+    const BookHeader *h = (const BookHeader *)mem;
+    if (memcmp(h->magic, BOOK_MAGIC, sizeof(BOOK_MAGIC)) != 0 || h->version != BOOK_VERSION ||
+        sizeof(BookHeader) + (size_t)h->count * sizeof(BookEntry) > (size_t)st.st_size) {
+        fprintf(stderr, "Invalid book file: %s\n", path);
+        munmap(mem, (size_t)st.st_size);
+        return -1;
+    }
+    book_map = mem;
+    book_bytes = (size_t)st.st_size;
+    book_entries = (const BookEntry *)((const char *)mem + sizeof(BookHeader));
+    book_count = h->count;
+    return 0;
+}
+
+void book_close(void) {
+    if (book_map) munmap(book_map, book_bytes);
+    book_map = NULL;
+    book_bytes = 0;
+    book_entries = NULL;
+    book_count = 0;
+}
+
+size_t book_size(void) {
+    return book_count;
+}
+
+// key 로 이진 탐색. 있으면 1
+int book_probe(uint64_t key, BookEntry *out) {
+    size_t lo = 0, hi = book_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        uint64_t k = book_entries[mid].key;
+        if (k == key) {
+            *out = book_entries[mid];
+            return 1;
+        }
+        if (k < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return 0;
+}
+
+static int cmp_entry(const void *a, const void *b) {
+    uint64_t ka = ((const BookEntry *)a)->key, kb = ((const BookEntry *)b)->key;
+    return ka < kb ? -1 : ka > kb;
+}
+
+// entries 를 key 순으로 정렬해서 저장 (같은 key 는 depth 가 깊은 것 하나만)
+int book_write(const char *path, BookEntry *entries, size_t count) {
+    qsort(entries, count, sizeof(BookEntry), cmp_entry);
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (n > 0 && entries[n - 1].key == entries[i].key) {
+            if (entries[i].depth > entries[n - 1].depth) entries[n - 1] = entries[i];
+            continue;
+        }
+        entries[n++] = entries[i];
+    }
+
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        perror("fopen book");
+        return -1;
+    }
+    BookHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, BOOK_MAGIC, sizeof(BOOK_MAGIC));
+    h.version = BOOK_VERSION;
+    h.count = (uint32_t)n;
+    int ok = fwrite(&h, sizeof(h), 1, fp) == 1 &&
+             fwrite(entries, sizeof(BookEntry), n, fp) == n;
+    if (fclose(fp) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "Failed to write book: %s\n", path);
+        return -1;
+    }
+    return (int)n;
+}
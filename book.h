@@ -0,0 +1,35 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game.h"
+
+#define BOOK_MAGIC    "OFBOOK1"
+#define BOOK_VERSION  1
+
+/*
+ * 파일 배치: BookHeader 뒤에 BookEntry count 개, key 오름차순.
+ * key 는 BitBoard.key (둘 차례 포함) 그대로라 client 는 mmap 한 배열을 이진 탐색만 한다.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+} BookHeader;
+
+typedef struct {
+    uint64_t key;
+    PackedMove move;
+    int16_t score;       // 둘 차례 기준 탐색 점수
+    uint8_t depth;       // 탐색 depth
+    uint8_t pad[3];
+} BookEntry;
+
+int book_open(const char *path);
+void book_close(void);
+size_t book_size(void);
+int book_probe(uint64_t key, BookEntry *out);
+int book_write(const char *path, BookEntry *entries, size_t count);
+
+#endif
@@ -0,0 +1,143 @@
+/*
+g++ -O2 -Iinclude src/bookgen.c src/book.c src/pattern.c src/nnue.c src/search.c src/tt.c src/game.c -lpthread -o bookgen
+./bookgen -p 3 -d 9 -o opening.book          # 시작 배치에서 3 ply 까지 모든 국면을 depth 9 로
+./bookgen -p 4 -m 500 -t 4 -o opening.book   # 국면마다 500ms, 4 스레드
+*/
+
+#include "../include/book.h"
+#include "../include/search.h"
+#include "../include/tt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int max_plies = 3;
+static int search_depth = 0;
+static int search_ms = 0;
+
+static BookEntry *entries = NULL;
+static size_t n_entries = 0, cap_entries = 0;
+
+// 이미 탐색한 국면 (open addressing, key 0 은 빈 칸)
+static uint64_t *seen = NULL;
+static size_t seen_mask = 0, n_seen = 0;
+
+static int seen_insert(uint64_t key) {
+    if (key == 0) key = 1;
+    if ((n_seen + 1) * 2 > seen_mask + 1) {
+        size_t old = seen_mask + 1, size = old * 2;
+        uint64_t *t = (uint64_t *)calloc(size, sizeof(uint64_t));
+        if (!t) { perror("calloc"); exit(EXIT_FAILURE); }
+        for (size_t i = 0; i < old; i++) {
+            if (!seen[i]) continue;
+            size_t j = seen[i] & (size - 1);
+            while (t[j]) j = (j + 1) & (size - 1);
+            t[j] = seen[i];
+        }
+        free(seen);
+        seen = t;
+        seen_mask = size - 1;
+    }
+    size_t j = key & seen_mask;
+    while (seen[j]) {
+        if (seen[j] == key) return 0;
+        j = (j + 1) & seen_mask;
+    }
+    seen[j] = key;
+    n_seen++;
+    return 1;
+}
+
+static void add_entry(const BitBoard *bb, const SearchResult *res) {
+    if (n_entries == cap_entries) {
+        cap_entries = cap_entries ? cap_entries * 2 : 1024;
+        entries = (BookEntry *)realloc(entries, cap_entries * sizeof(BookEntry));
+        if (!entries) { perror("realloc"); exit(EXIT_FAILURE); }
+    }
+    BookEntry *e = &entries[n_entries++];
+    memset(e, 0, sizeof(*e));
+    int score = res->score;
+    if (score > 32767) score = 32767;
+    if (score < -32767) score = -32767;
+    e->key = bb->key;
+    e->move = res->best;
+    e->score = (int16_t)score;
+    e->depth = (uint8_t)res->depth;
+}
+
+// ply 까지 양쪽의 모든 수를 펼친다. 같은 국면은 한 번만 탐색
+static void build(BitBoard *bb, int ply) {
+    if (ply >= max_plies || bb_is_game_over(bb)) return;
+    if (!seen_insert(bb->key)) return;
+
+    char me = bb_side(bb);
+    MoveList list;
+    if (generate_moves(bb, me, &list) == 0) return;
+
+    SearchLimits limits = { search_now() + (search_ms > 0 ? search_ms / 1000.0 : 3600.0),
+                            search_depth, NULL, 0 };
+    SearchResult res;
+    search_root(bb, me, &limits, &res);
+    if (res.depth > 0) {
+        add_entry(bb, &res);
+        if (n_entries % 100 == 0) {
+            printf("%zu positions (ply %d, depth %d)\n", n_entries, ply, res.depth);
+            fflush(stdout);
+        }
+    }
+
+    for (int i = 0; i < list.count; i++) {
+        MoveUndo undo;
+        make_move(bb, me, MV_FROM(list.moves[i]), MV_TO(list.moves[i]), &undo);
+        build(bb, ply + 1);
+        unmake_move(bb, &undo);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *out = "opening.book";
+    int threads = 1;
+    int hash_mb = TT_DEFAULT_MB;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+            max_plies = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            search_depth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+            search_ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc)
+            hash_mb = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out = argv[++i];
+        else {
+            printf("Usage: %s [-p plies] [-d depth] [-m ms] [-t threads] [--hash MB] [-o file]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (search_depth <= 0 && search_ms <= 0) search_depth = 8;
+
+    search_set_threads(threads);
+    if (tt_init((size_t)hash_mb, 0) < 0) return EXIT_FAILURE;
+    seen_mask = 1023;
+    seen = (uint64_t *)calloc(seen_mask + 1, sizeof(uint64_t));
+
+    char board[BOARD_SIZE][BOARD_SIZE];
+    init_board(board);
+    BitBoard bb;
+    bb_from_board(&bb, board);
+    bb_set_side(&bb, 'R');
+
+    double t0 = search_now();
+    build(&bb, 0);
+    int n = book_write(out, entries, n_entries);
+    if (n < 0) return EXIT_FAILURE;
+    printf("wrote %d positions to %s (%.1f s)\n", n, out, search_now() - t0);
+
+    free(entries);
+    free(seen);
+    tt_free();
+    return EXIT_SUCCESS;
+}
@@ -2,6 +2,11 @@
 #include "../include/game.h"
 #include "../include/json.h"
 #include "../include/board.h"
+#include "../include/search.h"
+#include "../include/tt.h"
+#include "../include/mcts.h"
+#include "../include/endgame.h"
+#include "../include/book.h"
 #include "../libs/cJSON.h"
 
 #include <stdio.h>
@@ -12,75 +17,208 @@
 #include <sys/socket.h>
 #include <netdb.h>
 #include <arpa/inet.h>
+#include <pthread.h>
 
 #define SIMULATION_TIME 3.0
+#define SAFETY_MARGIN   0.6     // 네트워크 왕복 + 직렬화 여유 (초)
 
-static char board_arr[BOARD_SIZE][BOARD_SIZE];
-
-int count_flips(char board[BOARD_SIZE][BOARD_SIZE],
-                int r, int c, char player_color) {
-    int flip_count = 0;
-    char opponent = (player_color == 'R') ? 'B' : 'R';
-    for (int d = 0; d < 8; ++d) {
-        int nr = r + directions[d][0];
-        int nc = c + directions[d][1];
-        if (nr >= 0 && nr < BOARD_SIZE && nc >= 0 && nc < BOARD_SIZE) {
-            if (board[nr][nc] == opponent) {
-                flip_count++;
-            }
-        }
+static char board_arr[BOARD_SIZE][BOARD_SIZE];   // LED 표시용
+static BitBoard board_bb;                        // 마지막으로 받은 보드 (JSON 행에서 바로 변환)
+static double turn_deadline = 0.0;  // your_turn 수신 시각 + timeout - SAFETY_MARGIN
+
+// -----------------------------------------------------------------------------
+//  Pondering: 내 수를 둔 뒤 상대 차례 동안 백그라운드에서 계속 탐색
+// -----------------------------------------------------------------------------
+typedef struct {
+    pthread_t tid;
+    int running;
+    int stop;
+    BitBoard pos;          // 탐색 중인 국면 (side 설정됨)
+    char player;
+    uint64_t expect_key;   // 예측한 상대 수 이후 내 차례 국면의 key, 예측 못 했으면 0
+    SearchResult result;
+} PonderState;
+
+static int ponder_enabled = 0;
+static PonderState ponder;
+static int engine = ENGINE_ALPHABETA;
+static int endgame_empties = EG_DEFAULT_EMPTIES;
+
+void client_set_ponder(int on) {
+    ponder_enabled = on;
+}
+
+void client_set_engine(int e) {
+    engine = e;
+}
+
+void client_set_endgame(int empties) {
+    endgame_empties = empties;
+}
+
+static void *ponder_main(void *arg) {
+    (void)arg;
+    SearchLimits limits = { search_now() + 3600.0, 0, &ponder.stop, 1 };
+    search_root(&ponder.pos, ponder.player, &limits, &ponder.result);
+    return NULL;
+}
+
+/*
+ * board 는 내 수가 반영된 상대 차례 국면.
+ * TT 에 상대 최선 응수(hash move)가 있으면 그 수를 둔 내 차례 국면을 탐색하고,
+ * 없으면 상대 차례 국면 자체를 탐색해 상대 응수 전체에 대한 TT 를 채운다.
+ */
+static void ponder_start(const BitBoard *pos, char my_color) {
+    if (!ponder_enabled || ponder.running || engine != ENGINE_ALPHABETA) return;
+    char opp = (my_color == 'R') ? 'B' : 'R';
+    BitBoard bb = *pos;
+    bb_set_side(&bb, opp);
+    if (bb_is_game_over(&bb)) return;
+
+    TTHit hit;
+    ponder.expect_key = 0;
+    ponder.player = opp;
+    if (!bb_has_valid_move(&bb, opp)) {
+        bb_pass(&bb);
+        ponder.player = my_color;
+        ponder.expect_key = bb.key;
+    } else if (tt_probe(bb.key, &hit) && hit.move != MV_NONE &&
+               bb_is_legal_move(&bb, opp, MV_FROM(hit.move), MV_TO(hit.move))) {
+        bb_move(&bb, opp, MV_FROM(hit.move), MV_TO(hit.move));
+        ponder.player = my_color;
+        ponder.expect_key = bb.key;
+    }
+    ponder.pos = bb;
+    ponder.stop = 0;
+    memset(&ponder.result, 0, sizeof(ponder.result));
+    if (pthread_create(&ponder.tid, NULL, ponder_main, NULL) == 0)
+        ponder.running = 1;
+}
+
+static void ponder_stop(void) {
+    if (!ponder.running) return;
+    __atomic_store_n(&ponder.stop, 1, __ATOMIC_RELAXED);
+    pthread_join(ponder.tid, NULL);
+    ponder.running = 0;
+}
+
+// 한 수 돌 이득 최대: flip-count 봇, 탐색이 depth 1 도 못 끝냈을 때의 대비책.
+// (from, to) 쌍마다 세지 않고 64 칸 목적지를 한 번에 평가한다 (bb_score_dests)
+static PackedMove flip_count_move(const BitBoard *bb, char player_color, const MoveList *list) {
+    if (list->count == 0) return MV_NONE;
+    return bb_greedy_move(bb, player_color);
+}
+
+// 반복 심화 alpha-beta (+ pondering 결과 이어받기)
+static PackedMove alphabeta_move(BitBoard *bb, char player_color, const MoveList *list,
+                                 double deadline) {
+    // 예측이 맞았으면 pondering 결과를 이어 쓴다 (TT 도 이미 채워져 있음)
+    bb_set_side(bb, player_color);
+    const SearchResult *pondered = NULL;
+    if (ponder.expect_key && ponder.expect_key == bb->key && ponder.result.depth > 0) {
+        pondered = &ponder.result;
+        printf("Ponder hit: depth %d\n", pondered->depth);
+    }
+    ponder.expect_key = 0;
+
+    SearchLimits limits = { deadline, 0, NULL, 0 };
+    SearchResult res;
+    search_root(bb, player_color, &limits, &res);
+
+    PackedMove mv = res.best;
+    if (pondered && pondered->depth > res.depth) {
+        mv = pondered->best;
+        res.depth = pondered->depth;
+        res.score = pondered->score;
+    }
+    if (res.depth == 0) mv = flip_count_move(bb, player_color, list);
+    printf("Search: depth %d, score %d, %llu nodes, %.2f s\n",
+           res.depth, res.score, (unsigned long long)res.nodes, res.elapsed);
+
+    return mv;
+}
+
+static int generate_move_bb(const BitBoard *pos, char player_color,
+                            int *out_r1, int *out_c1,
+                            int *out_r2, int *out_c2) {
+    BitBoard bb = *pos;
+    MoveList list;
+    if (generate_moves(&bb, player_color, &list) == 0) {
+        *out_r1 = *out_c1 = *out_r2 = *out_c2 = 0;
+        return 0;
+    }
+
+    double deadline = turn_deadline;
+    if (deadline <= 0.0)
+        deadline = search_now() + TIMEOUT - SAFETY_MARGIN;
+
+    PackedMove mv;
+    BookEntry be;
+    bb_set_side(&bb, player_color);
+    if (engine != ENGINE_FLIP && book_size() && book_probe(bb.key, &be) &&
+        bb_is_legal_move(&bb, player_color, MV_FROM(be.move), MV_TO(be.move))) {
+        // 오프닝 북: 탐색 없이 바로 (시간은 중반으로)
+        mv = be.move;
+        printf("Book: depth %d, score %d\n", be.depth, be.score);
+    } else if (engine != ENGINE_FLIP && bb.n_empty <= endgame_empties) {
+        // 빈칸이 적으면 끝까지 읽는다. 증명 못 했어도 가장 깊이 끝난 iteration 의 수를 쓴다
+        EndgameResult eg;
+        endgame_solve(&bb, player_color, deadline, &eg);
+        if (eg.exact)
+            printf("Endgame: solved, score %+d, %llu nodes, %.2f s\n",
+                   eg.score, (unsigned long long)eg.nodes, eg.elapsed);
+        else
+            printf("Endgame: not solved in time (cap %d plies, score %+d), %llu nodes, %.2f s\n",
+                   eg.cap, eg.score, (unsigned long long)eg.nodes, eg.elapsed);
+        mv = eg.cap ? eg.best : flip_count_move(&bb, player_color, &list);
+    } else if (engine == ENGINE_FLIP) {
+        mv = flip_count_move(&bb, player_color, &list);
+    } else if (engine == ENGINE_MCTS) {
+        // 이전 턴 트리에서 지금 국면의 subtree 를 이어받는다
+        MctsLimits mlimits = { deadline, 0, NULL };
+        MctsResult mres;
+        mcts_search(&bb, player_color, &mlimits, &mres);
+        mv = mres.best;
+        printf("MCTS: %llu playouts (reused %d), best %d visits, win %.1f%%, %.2f s\n",
+               (unsigned long long)mres.playouts, mres.reused, mres.visits,
+               100.0 * mres.win_rate, mres.elapsed);
+    } else {
+        mv = alphabeta_move(&bb, player_color, &list, deadline);
     }
-    return flip_count;
+
+    *out_r1 = BB_ROW(MV_FROM(mv)); *out_c1 = BB_COL(MV_FROM(mv));
+    *out_r2 = BB_ROW(MV_TO(mv));   *out_c2 = BB_COL(MV_TO(mv));
+    return 1;
 }
 
 int generate_move(char board[BOARD_SIZE][BOARD_SIZE], char player_color,
                   int *out_r1, int *out_c1,
                   int *out_r2, int *out_c2) {
-    sleep(2);
-    int best_score = -1;
-  
     update_led_matrix(board);
 
-    for (int r = 0; r < BOARD_SIZE; ++r) {
-        for (int c = 0; c < BOARD_SIZE; ++c) {
-            if (board[r][c] != player_color) continue;
-
-            // clone
-            for (int d = 0; d < 8; ++d) {
-                int nr = r + directions[d][0];
-                int nc = c + directions[d][1];
-                if (nr >= 0 && nr < BOARD_SIZE && nc >= 0 && nc < BOARD_SIZE &&
-                    board[nr][nc] == '.') {
-                    int flips = count_flips(board, nr, nc, player_color);
-                    if (flips > best_score) {
-                        best_score = flips;
-                        *out_r1 = r; *out_c1 = c;
-                        *out_r2 = nr; *out_c2 = nc;
-                    }
-                }
-            }
+    BitBoard bb;
+    bb_from_board(&bb, board);
+    return generate_move_bb(&bb, player_color, out_r1, out_c1, out_r2, out_c2);
+}
 
-            // jump
-            for (int d = 0; d < 8; ++d) {
-                int nr = r + 2 * directions[d][0];
-                int nc = c + 2 * directions[d][1];
-                if (nr >= 0 && nr < BOARD_SIZE && nc >= 0 && nc < BOARD_SIZE &&
-                    board[nr][nc] == '.') {
-                    int flips = count_flips(board, nr, nc, player_color);
-                    if (flips > best_score) {
-                        best_score = flips;
-                        *out_r1 = r; *out_c1 = c;
-                        *out_r2 = nr; *out_c2 = nc;
-                    }
-                }
-            }
-        }
+// 메시지의 "board" 를 board_bb 로 읽고 LED 를 갱신한다. 8 x 8 형식이 아니면 0 (board_bb 는 그대로)
+static int read_board(const cJSON *jbarr, const char *title) {
+    if (!jbarr || !cJSON_IsArray(jbarr) || cJSON_GetArraySize(jbarr) != BOARD_SIZE) return 0;
+    const char *rows[BOARD_SIZE];
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        const cJSON *jrow = cJSON_GetArrayItem(jbarr, i);
+        rows[i] = (jrow && cJSON_IsString(jrow)) ? jrow->valuestring : NULL;
     }
-
-    if (best_score == -1) {
-        *out_r1 = *out_c1 = *out_r2 = *out_c2 = 0;
+    if (!bb_from_rows(&board_bb, rows)) {
+        fprintf(stderr, "Malformed board in server message\n");
         return 0;
     }
+    if (title) {
+        printf("%s\n", title);
+        for (int i = 0; i < BOARD_SIZE; i++) printf("%.*s\n", BOARD_SIZE, rows[i]);
+    }
+    bb_to_board(&board_bb, board_arr);
+    update_led_matrix(board_arr);
     return 1;
 }
 
@@ -105,6 +243,7 @@ static int connect_to_server(const char *ip, const char *port) {
         fprintf(stderr, "Failed to connect to %s:%s\n", ip, port);
         return -1;
     }
+    json_set_nodelay(sockfd);
     return sockfd;
 }
 
@@ -114,15 +253,24 @@ int client_run(const char *ip, const char *port, const char *username) {
         fprintf(stderr, "Failed to connect to %s:%s\n", ip, port);
         return EXIT_FAILURE;
     }
+    JsonReader reader;
+    JsonWriter writer;
+    if (json_reader_init(&reader, JSON_MAX_MSG) < 0) {
+        close(sockfd);
+        return EXIT_FAILURE;
+    }
+    json_writer_init(&writer, JSON_MAX_MSG);
 
     // 1) register 요청
     {
         cJSON *reg = cJSON_CreateObject();
         cJSON_AddStringToObject(reg, "type", "register");
         cJSON_AddStringToObject(reg, "username", username);
-        if (send_json(sockfd, reg) < 0) {
+        if (send_json(&writer, sockfd, reg) < 0) {
             fprintf(stderr, "Failed to send register message\n");
             cJSON_Delete(reg);
+            json_reader_free(&reader);
+            json_writer_free(&writer);
             close(sockfd);
             return EXIT_FAILURE;
         }
@@ -133,7 +281,8 @@ int client_run(const char *ip, const char *port, const char *username) {
     char my_color = 0;
 
     while (1) {
-        cJSON *msg = recv_json(sockfd);
+        cJSON *msg = recv_json(&reader, sockfd);
+        ponder_stop();  // 새 메시지가 오면 상대 수가 끝난 것, 탐색 중단
         if (!msg) {
             // 서버 연결이 끊기거나 오류 발생
             break;
@@ -179,30 +328,24 @@ int client_run(const char *ip, const char *port, const char *username) {
         }
         // 2-4) your_turn (board + timeout 전달)
         else if (strcmp(type, "your_turn") == 0) {
-            cJSON *jbarr = cJSON_GetObjectItem(msg, "board");
-            if (jbarr && cJSON_IsArray(jbarr)) {
-                int nrows = cJSON_GetArraySize(jbarr);
-                printf("Current board:\n");
-                for (int i = 0; i < nrows && i < BOARD_SIZE; i++) {
-                    const cJSON *jrow = cJSON_GetArrayItem(jbarr, i);
-                    if (jrow && jrow->valuestring) {
-                        memcpy(board_arr[i], jrow->valuestring, BOARD_SIZE);
-                        update_led_matrix(board_arr);
-                        char rowbuf[BOARD_SIZE+1];
-                        memcpy(rowbuf, jrow->valuestring, BOARD_SIZE);
-                        rowbuf[BOARD_SIZE] = '\0';
-                        printf("%s\n", rowbuf);
-                    }
-                }
+            double received = search_now();
+            // 보드를 못 읽으면 아무 수도 보내지 않는다 (모르는 국면에서 두지 않음)
+            if (!read_board(cJSON_GetObjectItem(msg, "board"), "Current board:")) {
+                cJSON_Delete(msg);
+                continue;
             }
             // timeout
             cJSON *jtimeout = cJSON_GetObjectItem(msg, "timeout");
-            if (jtimeout)
-                printf("Timeout: %.1f s\n", jtimeout->valuedouble);
+            double timeout = TIMEOUT;
+            if (jtimeout && cJSON_IsNumber(jtimeout) && jtimeout->valuedouble > 0) {
+                timeout = jtimeout->valuedouble;
+                printf("Timeout: %.1f s\n", timeout);
+            }
+            turn_deadline = received + timeout - SAFETY_MARGIN;
 
             printf("Your turn (%c)\n", my_color);
             int r1, c1, r2, c2;
-            int has_move = generate_move(board_arr, my_color, &r1, &c1, &r2, &c2);
+            int has_move = generate_move_bb(&board_bb, my_color, &r1, &c1, &r2, &c2);
 
             // move, pass
             cJSON *mv = cJSON_CreateObject();
@@ -220,7 +363,7 @@ int client_run(const char *ip, const char *port, const char *username) {
                 cJSON_AddNumberToObject(mv, "tx", 0);
                 cJSON_AddNumberToObject(mv, "ty", 0);
             }
-            if (send_json(sockfd, mv) < 0) {
+            if (send_json(&writer, sockfd, mv) < 0) {
                 fprintf(stderr, "Failed to send move/pass message\n");
                 cJSON_Delete(mv);
                 cJSON_Delete(msg);
@@ -236,21 +379,16 @@ int client_run(const char *ip, const char *port, const char *username) {
                  strcmp(type, "invalid_move") == 0 ||
                  strcmp(type, "pass") == 0)
         {
+            int my_result = waiting_for_result;
             if (waiting_for_result) {
                 printf("Move result: %s\n", type);
                 printf("Next player's turn\n");
                 waiting_for_result = 0;
             }
-            cJSON *jbarr = cJSON_GetObjectItem(msg, "board");
-            if (jbarr && cJSON_IsArray(jbarr)) {
-                int nrows = cJSON_GetArraySize(jbarr);
-                for (int i = 0; i < nrows && i < BOARD_SIZE; i++) {
-                    const cJSON *jrow = cJSON_GetArrayItem(jbarr, i);
-                    if (jrow && jrow->valuestring) {
-                        memcpy(board_arr[i], jrow->valuestring, BOARD_SIZE);
-                    }
-                }
-                update_led_matrix(board_arr);
+            if (read_board(cJSON_GetObjectItem(msg, "board"), NULL)) {
+                // 내 수(또는 pass)가 받아들여졌으면 상대 차례 동안 ponder
+                if (my_result && strcmp(type, "invalid_move") != 0)
+                    ponder_start(&board_bb, my_color);
             }
             cJSON_Delete(msg);
             continue;
@@ -258,22 +396,7 @@ int client_run(const char *ip, const char *port, const char *username) {
         // game_over
         else if (strcmp(type, "game_over") == 0) {
             printf("Game Over\n");
-            cJSON *jbarr = cJSON_GetObjectItem(msg, "board");
-            if (jbarr && cJSON_IsArray(jbarr)) {
-                int nrows = cJSON_GetArraySize(jbarr);
-                printf("Final board:\n");
-                for (int i = 0; i < nrows && i < BOARD_SIZE; i++) {
-                    const cJSON *jrow = cJSON_GetArrayItem(jbarr, i);
-                    if (jrow && jrow->valuestring) {
-                        memcpy(board_arr[i], jrow->valuestring, BOARD_SIZE);
-                        char rowbuf[BOARD_SIZE+1];
-                        memcpy(rowbuf, jrow->valuestring, BOARD_SIZE);
-                        rowbuf[BOARD_SIZE] = '\0';
-                        printf("%s\n", rowbuf);
-                    }
-                }
-                update_led_matrix(board_arr);
-            }
+            read_board(cJSON_GetObjectItem(msg, "board"), "Final board:");
           // score
             cJSON *jscores = cJSON_GetObjectItem(msg, "scores");
             if (jscores && cJSON_IsObject(jscores)) {
@@ -292,6 +415,9 @@ int client_run(const char *ip, const char *port, const char *username) {
         cJSON_Delete(msg);
     }
 
+    ponder_stop();
+    json_reader_free(&reader);
+    json_writer_free(&writer);
     close(sockfd);
     return EXIT_SUCCESS;
 }
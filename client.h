@@ -3,8 +3,14 @@
 
 #include "server.h"
 
+// 수 선택 엔진 (main 의 -e 옵션)
+enum { ENGINE_ALPHABETA = 0, ENGINE_MCTS = 1, ENGINE_FLIP = 2 };
+
 int generate_move(char board[BOARD_SIZE][BOARD_SIZE], char player_color, int *out_r1, int *out_c1, int *out_r2, int *out_c2);
 static int connect_to_server(const char *ip, const char *port);
 int client_run(const char *ip, const char *port, const char *username);
+void client_set_ponder(int on);
+void client_set_engine(int engine);
+void client_set_endgame(int empties);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "../include/endgame.h"
+#include "../include/search.h"
+#include <stdio.h>
+#include <string.h>
+
+#define EG_CHECK_EVERY  1023
+#define EG_HASH_SIZE    (1u << EG_HASH_BITS)
+#define EG_INF          1000
+
+enum { EG_EXACT = 1, EG_LOWER = 2, EG_UPPER = 3 };
+
+// 16B entry. proven 이면 cap 과 상관없이 재사용 가능
+typedef struct {
+    uint64_t key;
+    int16_t score;
+    PackedMove move;
+    uint8_t plies;       // 저장할 때 남아 있던 ply 수
+    uint8_t bound;
+    uint8_t proven;
+    uint8_t pad;
+} EgEntry;
+
+static EgEntry eg_table[EG_HASH_SIZE];
+
+typedef struct {
+    double deadline;
+    uint64_t nodes;
+    int stopped;
+    int capped;          // 현재 subtree 에서 cap 에 걸린 leaf 가 있었는지
+} EgCtx;
+
+static inline int disc_diff(const BitBoard *bb, char me) {
+    return me == 'R' ? (int)bb->n_red - (int)bb->n_blue : (int)bb->n_blue - (int)bb->n_red;
+}
+
+// 상대가 다음에 갈 수 있는 빈칸 수 (적을수록 먼저: fastest-first)
+static inline int opp_mobility(const BitBoard *bb, char opp) {
+    uint64_t o = bb_own(bb, opp);
+    return bb_popcount((bb_adjacent(o) | bb_jump_targets(o)) & bb_empty(bb));
+}
+
+static void order_moves(BitBoard *bb, char me, MoveList *list, PackedMove hash_move, int *keys) {
+    char opp = (me == 'R') ? 'B' : 'R';
+    for (int i = 0; i < list->count; i++) {
+        PackedMove mv = list->moves[i];
+        if (mv == hash_move) { keys[i] = -1000; continue; }
+        MoveUndo undo;
+        make_move(bb, me, MV_FROM(mv), MV_TO(mv), &undo);
+        // 상대 이동성 우선, 같으면 clone(돌이 늘어나는 수) 먼저
+        keys[i] = opp_mobility(bb, opp) * 2 + MV_JUMP(mv);
+        unmake_move(bb, &undo);
+    }
+}
+
+static inline void pick_next(MoveList *list, int *keys, int i) {
+    int best = i;
+    for (int j = i + 1; j < list->count; j++)
+        if (keys[j] < keys[best]) best = j;
+    if (best != i) {
+        PackedMove m = list->moves[i]; list->moves[i] = list->moves[best]; list->moves[best] = m;
+        int k = keys[i]; keys[i] = keys[best]; keys[best] = k;
+    }
+}
+
+static int eg_search(EgCtx *ctx, BitBoard *bb, int plies, int alpha, int beta) {
+    if ((++ctx->nodes & EG_CHECK_EVERY) == 0 && search_now() >= ctx->deadline)
+        ctx->stopped = 1;
+    if (ctx->stopped) return 0;
+
+    char me = bb_side(bb);
+    if (bb_is_game_over(bb)) return disc_diff(bb, me);
+    if (plies <= 0) {
+        ctx->capped = 1;
+        return disc_diff(bb, me);
+    }
+
+    EgEntry *e = &eg_table[bb->key & (EG_HASH_SIZE - 1)];
+    PackedMove hash_move = MV_NONE;
+    if (e->key == bb->key) {
+        hash_move = e->move;
+        if (e->proven || e->plies >= plies) {
+            int s = e->score;
+            if (e->bound == EG_EXACT ||
+                (e->bound == EG_LOWER && s >= beta) ||
+                (e->bound == EG_UPPER && s <= alpha)) {
+                if (!e->proven) ctx->capped = 1;
+                return s;
+            }
+        }
+    }
+
+    int outer_capped = ctx->capped;
+    ctx->capped = 0;
+
+    MoveList list;
+    int n = generate_moves(bb, me, &list);
+    int best = -EG_INF;
+    PackedMove best_move = MV_NONE;
+    int alpha_orig = alpha;
+
+    if (n == 0) {
+        // game_loop 과 같음: 상대도 둘 곳이 없으면 연속 pass 로 종료
+        if (!bb_has_valid_move(bb, me == 'R' ? 'B' : 'R')) {
+            best = disc_diff(bb, me);
+        } else {
+            bb_pass(bb);
+            best = -eg_search(ctx, bb, plies - 1, -beta, -alpha);
+            bb_pass(bb);
+        }
+    } else {
+        int keys[MAX_MOVES];
+        order_moves(bb, me, &list, hash_move, keys);
+        for (int i = 0; i < n; i++) {
+            pick_next(&list, keys, i);
+            MoveUndo undo;
+            make_move(bb, me, MV_FROM(list.moves[i]), MV_TO(list.moves[i]), &undo);
+            int v = -eg_search(ctx, bb, plies - 1, -beta, -alpha);
+            unmake_move(bb, &undo);
+            if (ctx->stopped) return 0;
+            if (v > best) { best = v; best_move = list.moves[i]; }
+            if (v > alpha) alpha = v;
+            if (alpha >= beta) break;
+        }
+    }
+    if (ctx->stopped) return 0;
+
+    int proven = !ctx->capped;
+    ctx->capped |= outer_capped;
+
+    e->key = bb->key;
+    e->score = (int16_t)best;
+    e->move = best_move;
+    e->plies = (uint8_t)(plies > 255 ? 255 : plies);
+    e->bound = best <= alpha_orig ? EG_UPPER : best >= beta ? EG_LOWER : EG_EXACT;
+    e->proven = (uint8_t)proven;
+    return best;
+}
+
+/*
+ * cap 을 빈칸 수부터 2 씩 늘려 가며 반복, 증명되면(exact) 바로 끝.
+ * deadline 에 걸려 중간에 끊긴 iteration 은 버린다.
+ * 반환값: 둘 수 있는 수가 있으면 1, pass 면 0
+ */
+int endgame_solve(const BitBoard *root, char player, double deadline, EndgameResult *result) {
+    EgCtx ctx = { deadline, 0, 0, 0 };
+    BitBoard bb = *root;
+    bb_set_side(&bb, player);
+    memset(result, 0, sizeof(*result));
+    double start = search_now();
+
+    MoveList list;
+    int n = generate_moves(&bb, player, &list);
+    if (n == 0) return 0;
+    result->best = list.moves[0];
+    memset(eg_table, 0, sizeof(eg_table));
+
+    int keys[MAX_MOVES];
+    order_moves(&bb, player, &list, MV_NONE, keys);
+    for (int i = 0; i < n; i++) pick_next(&list, keys, i);
+
+    for (int cap = bb.n_empty > 1 ? bb.n_empty : 2; cap < 255; cap += 2) {
+        int alpha = -EG_INF, beta = EG_INF, best_idx = 0;
+        ctx.capped = 0;
+        for (int i = 0; i < n; i++) {
+            MoveUndo undo;
+            make_move(&bb, player, MV_FROM(list.moves[i]), MV_TO(list.moves[i]), &undo);
+            int v = -eg_search(&ctx, &bb, cap - 1, -beta, -alpha);
+            unmake_move(&bb, &undo);
+            if (ctx.stopped) break;
+            if (v > alpha) { alpha = v; best_idx = i; }
+        }
+        if (ctx.stopped) break;
+
+        PackedMove bm = list.moves[best_idx];
+        memmove(&list.moves[1], &list.moves[0], best_idx * sizeof(PackedMove));
+        list.moves[0] = bm;
+
+        result->best = bm;
+        result->score = alpha;
+        result->cap = cap;
+        result->exact = !ctx.capped;
+        if (result->exact) break;
+    }
+    result->nodes = ctx.nodes;
+    result->elapsed = search_now() - start;
+    return 1;
+}
@@ -0,0 +1,26 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include <stdint.h>
+#include "game.h"
+
+#define EG_DEFAULT_EMPTIES  6      // 빈칸이 이 이하이면 solver 사용 (0 = 끔)
+#define EG_HASH_BITS        16     // 전용 hash: 2^16 entry x 16B = 1MB
+
+/*
+ * jump 는 빈칸을 줄이지 않아서 게임 길이에 상한이 없다.
+ * 그래서 남은 수(cap)를 빈칸 수부터 2 씩 늘려 가며 탐색하고,
+ * cap 에 걸린 leaf 가 하나도 없이 끝난 iteration 만 exact 로 인정한다.
+ */
+typedef struct {
+    PackedMove best;     // 마지막으로 끝난 iteration 의 최선 수
+    int score;           // 둘 차례 기준 최종 돌 차이 (exact 가 아니면 cap 시점 돌 차이)
+    int exact;           // 1 이면 끝까지 읽은 증명된 값
+    int cap;             // 마지막으로 끝난 iteration 의 ply 상한, 하나도 못 끝냈으면 0
+    uint64_t nodes;
+    double elapsed;
+} EndgameResult;
+
+int endgame_solve(const BitBoard *root, char player, double deadline, EndgameResult *result);
+
+#endif
@@ -1,16 +1,84 @@
 #include "../include/server.h"
+#include "../include/game.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define IS_WS(ch)   ((ch)==' ' || (ch)=='\t' || (ch)=='\n' || (ch)=='\r' || \
-                     (ch)=='\f' || (ch)=='\v')
-#define VALID_CH(ch) ((ch)=='R' || (ch)=='B' || (ch)=='.' || (ch)=='#')
-static const int directions[8][2] = {
-    {-1,  0}, { 1,  0}, { 0, -1}, { 0,  1},
-    {-1, -1}, {-1,  1}, { 1, -1}, { 1,  1}
-};
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
+// -----------------------------------------------------------------------------
+//  64칸 char 보드 커널 (AVX2 / SSE2 / scalar)
+//  cells 는 row-major 64 바이트, 결과 비트 i == cells[i]
+// -----------------------------------------------------------------------------
+#if defined(__AVX2__)
+static inline uint64_t cells_match(const char *cells, char ch) {
+    __m256i key = _mm256_set1_epi8(ch);
+    __m256i lo = _mm256_loadu_si256((const __m256i *)cells);
+    __m256i hi = _mm256_loadu_si256((const __m256i *)(cells + 32));
+    uint32_t mlo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, key));
+    uint32_t mhi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, key));
+    return (uint64_t)mlo | ((uint64_t)mhi << 32);
+}
+static inline int cells_valid(const char *cells) {
+    __m256i r = _mm256_set1_epi8('R'), b = _mm256_set1_epi8('B');
+    __m256i d = _mm256_set1_epi8('.'), o = _mm256_set1_epi8('#');
+    __m256i ok = _mm256_set1_epi8(-1);
+    for (int i = 0; i < 64; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(cells + i));
+        __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, r), _mm256_cmpeq_epi8(v, b)),
+                                    _mm256_or_si256(_mm256_cmpeq_epi8(v, d), _mm256_cmpeq_epi8(v, o)));
+        ok = _mm256_and_si256(ok, m);
+    }
+    return (uint32_t)_mm256_movemask_epi8(ok) == 0xFFFFFFFFu;
+}
+#elif defined(__SSE2__)
+static inline uint64_t cells_match(const char *cells, char ch) {
+    __m128i key = _mm_set1_epi8(ch);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(cells + 16 * i));
+        mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, key)) << (16 * i);
+    }
+    return mask;
+}
+static inline int cells_valid(const char *cells) {
+    __m128i r = _mm_set1_epi8('R'), b = _mm_set1_epi8('B');
+    __m128i d = _mm_set1_epi8('.'), o = _mm_set1_epi8('#');
+    __m128i ok = _mm_set1_epi8(-1);
+    for (int i = 0; i < 64; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(cells + i));
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, r), _mm_cmpeq_epi8(v, b)),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v, d), _mm_cmpeq_epi8(v, o)));
+        ok = _mm_and_si128(ok, m);
+    }
+    return _mm_movemask_epi8(ok) == 0xFFFF;
+}
+#else
+static inline uint64_t cells_match(const char *cells, char ch) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++)
+        if (cells[i] == ch) mask |= BB_BIT(i);
+    return mask;
+}
+static inline int cells_valid(const char *cells) {
+    for (int i = 0; i < 64; i++)
+        if (!VALID_CH(cells[i])) return 0;
+    return 1;
+}
+#endif
+
+// 시작 배치: 모서리에 R 두 개, B 두 개
+void init_board(char board[BOARD_SIZE][BOARD_SIZE]) {
+    memset(board, '.', BOARD_SIZE * BOARD_SIZE);
+    board[0][0] = 'R';
+    board[0][BOARD_SIZE - 1] = 'B';
+    board[BOARD_SIZE - 1][0] = 'B';
+    board[BOARD_SIZE - 1][BOARD_SIZE - 1] = 'R';
+}
 int readCoordinates(int *r1, int *c1, int *r2, int *c2) {
     char buffer[256];
     int consumed;
@@ -24,12 +92,9 @@ int readCoordinates(int *r1, int *c1, int *r2, int *c2) {
     }
     (*r1)--; (*c1)--; (*r2)--; (*c2)--;
     return 1;
-}int isValidInput(char board[BOARD_SIZE][BOARD_SIZE], int r1, int c1, int r2, int c2) {
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            if (!VALID_CH(board[i][j])) return 0;
-        }
-    }
+}
+int isValidInput(char board[BOARD_SIZE][BOARD_SIZE], int r1, int c1, int r2, int c2) {
+    if (!cells_valid(&board[0][0])) return 0;
     if (r1 < 0 || r1 >= BOARD_SIZE || c1 < 0 || c1 >= BOARD_SIZE) return 0;
     if (r2 < 0 || r2 >= BOARD_SIZE || c2 < 0 || c2 >= BOARD_SIZE) return 0;
     return 1;
@@ -45,87 +110,46 @@ int isValidMove(char board[BOARD_SIZE][BOARD_SIZE],
 }
 int Move(char board[BOARD_SIZE][BOARD_SIZE], int turn,
          int r1, int c1, int r2, int c2) {
-    int dr = abs(r1 - r2);
-    int dc = abs(c1 - c2);
-    for (int d = 0; d < 8; d++) {
-        if (dr == abs(directions[d][0]) && dc == abs(directions[d][1])) {
-            // copy
-            board[r2][c2] = board[r1][c1];
-            // flip neighbors
-            for (int k = 0; k < 8; k++) {
-                int nr = r2 + directions[k][0];
-                int nc = c2 + directions[k][1];
-                if (nr >= 0 && nr < BOARD_SIZE && nc >= 0 && nc < BOARD_SIZE) {
-                    if (board[nr][nc] != '.' && board[nr][nc] != '#' 
-                        && board[nr][nc] != board[r2][c2]) {
-                        board[nr][nc] = board[r2][c2];
-                    }
-                }
-            }
-            return 1;
-        }
-    }
-    // jump: two cells away (orthogonal or diagonal)
-    if ((dr == 2 && dc == 0) || (dr == 0 && dc == 2) || (dr == 2 && dc == 2)) {
-        board[r2][c2] = board[r1][c1];
-        board[r1][c1] = '.';
-        // flip neighbors
-        for (int k = 0; k < 8; k++) {
-            int nr = r2 + directions[k][0];
-            int nc = c2 + directions[k][1];
-            if (nr >= 0 && nr < BOARD_SIZE && nc >= 0 && nc < BOARD_SIZE) {
-                if (board[nr][nc] != '.' && board[nr][nc] != '#' 
-                    && board[nr][nc] != board[r2][c2]) {
-                    board[nr][nc] = board[r2][c2];
-                }
-            }
-        }
-        return 1;
+    (void)turn;
+    char me = board[r1][c1];
+    if (me != 'R' && me != 'B') return 0;
+
+    BitBoard bb;
+    bb_from_board(&bb, board);
+    uint64_t before = bb_own(&bb, me);
+    if (!bb_move(&bb, me, BB_SQ(r1, c1), BB_SQ(r2, c2))) return 0; // invalid action
+    uint64_t after = bb_own(&bb, me);
+
+    // 바뀐 칸만 char 보드에 반영 (목적지 + flip, jump 면 출발지 비움)
+    for (uint64_t m = after & ~before; m; m &= m - 1) {
+        int sq = bb_lsb(m);
+        board[BB_ROW(sq)][BB_COL(sq)] = me;
     }
-    return 0; // invalid action
+    if (before & ~after) board[r1][c1] = '.';
+    return 1;
 }
 int hasValidMove(char board[BOARD_SIZE][BOARD_SIZE], char currentPlayer) {
-    for (int i = 0; i < BOARD_SIZE; i++) {
-        for (int j = 0; j < BOARD_SIZE; j++) {
-            if (board[i][j] == currentPlayer) {
-                // check adjacent
-                for (int d = 0; d < 8; d++) {
-                    int nr = i + directions[d][0];
-                    int nc = j + directions[d][1];
-                    if (nr>=0 && nr<BOARD_SIZE && nc>=0 && nc<BOARD_SIZE 
-                        && board[nr][nc]=='.') return 1;
-                }
-                // check jump
-                for (int d = 0; d < 8; d++) {
-                    int nr = i + 2*directions[d][0];
-                    int nc = j + 2*directions[d][1];
-                    if (nr>=0 && nr<BOARD_SIZE && nc>=0 && nc<BOARD_SIZE 
-                        && board[nr][nc]=='.') return 1;
-                }
-            }
-        }
-    }
-    return 0;
+    BitBoard bb;
+    bb_from_board(&bb, board);
+    return bb_has_valid_move(&bb, currentPlayer);
 }
 int countDot(char board[BOARD_SIZE][BOARD_SIZE]) {
-    int cnt=0; for(int i=0;i<BOARD_SIZE;i++) for(int j=0;j<BOARD_SIZE;j++) if(board[i][j]=='.') cnt++; return cnt;
+    BitBoard bb; bb_from_board(&bb, board); return bb.n_empty;
 }
 int countR(char board[BOARD_SIZE][BOARD_SIZE]) {
-    int cnt=0; for(int i=0;i<BOARD_SIZE;i++) for(int j=0;j<BOARD_SIZE;j++) if(board[i][j]=='R') cnt++; return cnt;
+    BitBoard bb; bb_from_board(&bb, board); return bb.n_red;
 }
 int countB(char board[BOARD_SIZE][BOARD_SIZE]) {
-    int cnt=0; for(int i=0;i<BOARD_SIZE;i++) for(int j=0;j<BOARD_SIZE;j++) if(board[i][j]=='B') cnt++; return cnt;
+    BitBoard bb; bb_from_board(&bb, board); return bb.n_blue;
 }
 int countObstacle(char board[BOARD_SIZE][BOARD_SIZE]) {
-    int cnt=0; for(int i=0;i<BOARD_SIZE;i++) for(int j=0;j<BOARD_SIZE;j++) if(board[i][j]=='#') cnt++; return cnt;
+    BitBoard bb; bb_from_board(&bb, board); return bb.n_obstacle;
 }
 
 int isGameOver(char board[BOARD_SIZE][BOARD_SIZE]) {
-    if (countDot(board)==0) return 1;
-    if (countR(board)==0 || countB(board)==0) return 1;
-    if (countObstacle(board) == BOARD_SIZE*BOARD_SIZE) return 1;
-    if (countR(board)+countB(board) == BOARD_SIZE*BOARD_SIZE) return 1;
-    return 0;
+    BitBoard bb;
+    bb_from_board(&bb, board);
+    return bb_is_game_over(&bb);
 }
 void printResult(char board[BOARD_SIZE][BOARD_SIZE]) {
     for (int i = 0; i < BOARD_SIZE; i++) {
@@ -134,8 +158,262 @@ void printResult(char board[BOARD_SIZE][BOARD_SIZE]) {
         }
         putchar('\n');
     }
-    int r = countR(board), b = countB(board);
+    BitBoard bb;
+    bb_from_board(&bb, board);
+    int r = bb.n_red, b = bb.n_blue;
     if (r > b) printf("Red\n");
     else if (b > r) printf("Blue\n");
     else printf("Draw\n");
 }
+
+// -----------------------------------------------------------------------------
+//  bitboard rules core
+// -----------------------------------------------------------------------------
+static void bb_set_masks(BitBoard *bb, uint64_t red, uint64_t blue, uint64_t obstacle) {
+    bb->red      = red;
+    bb->blue     = blue;
+    bb->obstacle = obstacle;
+    bb->n_red      = (uint8_t)bb_popcount(bb->red);
+    bb->n_blue     = (uint8_t)bb_popcount(bb->blue);
+    bb->n_obstacle = (uint8_t)bb_popcount(bb->obstacle);
+    bb->n_empty    = (uint8_t)bb_popcount(bb_empty(bb));
+    bb->side       = 0;  // 기본은 R 차례, 필요하면 bb_set_side
+    bb->key        = bb_compute_key(bb);
+}
+void bb_from_board(BitBoard *bb, char board[BOARD_SIZE][BOARD_SIZE]) {
+    const char *cells = &board[0][0];
+    bb_set_masks(bb, cells_match(cells, 'R'), cells_match(cells, 'B'), cells_match(cells, '#'));
+}
+/*
+ * JSON "board" 의 8개 행 문자열에서 char 보드를 거치지 않고 바로 변환.
+ * 각 행의 앞 8 글자만 본다 (기존 서버는 행을 '\0' 없이 보내 8 글자보다 길게 온다).
+ * 8 글자가 안 되거나 R/B/./# 가 아닌 글자가 있으면 0 (bb 는 그대로).
+ * 검사와 mask 추출을 같은 비교로 한다.
+ */
+int bb_from_rows(BitBoard *bb, const char *const rows[BOARD_SIZE]) {
+    for (int i = 0; i < BOARD_SIZE; i++)
+        if (!rows[i] || strnlen(rows[i], BOARD_SIZE) < BOARD_SIZE) return 0;
+
+    uint64_t red = 0, blue = 0, obstacle = 0, known = 0;
+#if defined(__SSE2__)
+    uint64_t line[BOARD_SIZE];
+    for (int i = 0; i < BOARD_SIZE; i++) memcpy(&line[i], rows[i], BOARD_SIZE);
+    // 두 행(16 바이트)씩: 기호마다 compare 한 번, movemask 한 번
+    const __m128i r = _mm_set1_epi8('R'), b = _mm_set1_epi8('B');
+    const __m128i d = _mm_set1_epi8('.'), o = _mm_set1_epi8('#');
+    for (int i = 0; i < BOARD_SIZE; i += 2) {
+        __m128i v = _mm_set_epi64x((long long)line[i + 1], (long long)line[i]);
+        __m128i mr = _mm_cmpeq_epi8(v, r), mb = _mm_cmpeq_epi8(v, b), mo = _mm_cmpeq_epi8(v, o);
+        __m128i all = _mm_or_si128(_mm_or_si128(mr, mb), _mm_or_si128(mo, _mm_cmpeq_epi8(v, d)));
+        int shift = BOARD_SIZE * i;
+        red      |= (uint64_t)(uint16_t)_mm_movemask_epi8(mr) << shift;
+        blue     |= (uint64_t)(uint16_t)_mm_movemask_epi8(mb) << shift;
+        obstacle |= (uint64_t)(uint16_t)_mm_movemask_epi8(mo) << shift;
+        known    |= (uint64_t)(uint16_t)_mm_movemask_epi8(all) << shift;
+    }
+#else
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        for (int j = 0; j < BOARD_SIZE; j++) {
+            char ch = rows[i][j];
+            uint64_t bit = BB_BIT(BB_SQ(i, j));
+            if (ch == 'R') red |= bit;
+            else if (ch == 'B') blue |= bit;
+            else if (ch == '#') obstacle |= bit;
+            if (VALID_CH(ch)) known |= bit;
+        }
+    }
+#endif
+    if (known != ~0ULL) return 0;
+    bb_set_masks(bb, red, blue, obstacle);
+    return 1;
+}
+void bb_to_board(const BitBoard *bb, char board[BOARD_SIZE][BOARD_SIZE]) {
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        for (int j = 0; j < BOARD_SIZE; j++) {
+            uint64_t bit = BB_BIT(BB_SQ(i, j));
+            if (bb->red & bit) board[i][j] = 'R';
+            else if (bb->blue & bit) board[i][j] = 'B';
+            else if (bb->obstacle & bit) board[i][j] = '#';
+            else board[i][j] = '.';
+        }
+    }
+}
+// 출발지가 내 돌, 목적지가 빈칸, 거리가 clone(1) 또는 jump(2) 인지
+int bb_is_legal_move(const BitBoard *bb, char player, int from, int to) {
+    uint64_t src = BB_BIT(from), dst = BB_BIT(to);
+    if (!(bb_own(bb, player) & src)) return 0;
+    if (!(bb_empty(bb) & dst)) return 0;
+    return ((BB_ADJ_MASK[from] | BB_JUMP_MASK[from]) & dst) != 0;
+}
+// to 에 player 돌을 놓았을 때 뒤집히는 상대 돌
+uint64_t bb_flips(const BitBoard *bb, char player, int to) {
+    return BB_FLIP_MASK[to] & bb_opp(bb, player);
+}
+int bb_move(BitBoard *bb, char player, int from, int to) {
+    MoveUndo undo;
+    return make_move(bb, player, from, to, &undo);
+}
+int make_move(BitBoard *bb, char player, int from, int to, MoveUndo *undo) {
+    uint64_t src = BB_BIT(from), dst = BB_BIT(to);
+    uint64_t *own = (player == 'R') ? &bb->red : &bb->blue;
+    uint64_t *opp = (player == 'R') ? &bb->blue : &bb->red;
+    uint8_t *n_own = (player == 'R') ? &bb->n_red : &bb->n_blue;
+    uint8_t *n_opp = (player == 'R') ? &bb->n_blue : &bb->n_red;
+    const uint64_t *z_own = (player == 'R') ? ZOBRIST_RED : ZOBRIST_BLUE;
+
+    if (!(bb_empty(bb) & dst)) return 0;
+    undo->from = (uint8_t)from;
+    undo->to   = (uint8_t)to;
+    undo->key  = bb->key;
+    undo->side = bb->side;
+    if (BB_ADJ_MASK[from] & dst) {
+        // clone: 출발지 유지, 빈칸 하나 줄어듦
+        undo->jump = 0;
+        *n_own += 1;
+        bb->n_empty -= 1;
+    } else if (BB_JUMP_MASK[from] & dst) {
+        undo->jump = 1;
+        *own &= ~src;  // jump: 출발지 비움 (빈칸 수 그대로)
+        bb->key ^= z_own[from];
+    } else {
+        return 0;
+    }
+    uint64_t flips = BB_FLIP_MASK[to] & *opp;
+    int nflip = bb_popcount(flips);
+    undo->flips = flips;
+    *opp &= ~flips;
+    *own |= dst | flips;
+    *n_own += nflip;
+    *n_opp -= nflip;
+
+    bb->key ^= z_own[to];
+    for (uint64_t m = flips; m; m &= m - 1)
+        bb->key ^= ZOBRIST_FLIP[bb_lsb(m)];
+    bb_set_side(bb, player == 'R' ? 'B' : 'R');
+    return 1;
+}
+void unmake_move(BitBoard *bb, const MoveUndo *undo) {
+    uint64_t dst = BB_BIT(undo->to);
+    int is_red = (bb->red & dst) != 0;   // 목적지 돌 색 == 둔 사람
+    uint64_t *own = is_red ? &bb->red : &bb->blue;
+    uint64_t *opp = is_red ? &bb->blue : &bb->red;
+    uint8_t *n_own = is_red ? &bb->n_red : &bb->n_blue;
+    uint8_t *n_opp = is_red ? &bb->n_blue : &bb->n_red;
+    int nflip = bb_popcount(undo->flips);
+
+    *own &= ~(dst | undo->flips);
+    *opp |= undo->flips;
+    *n_own -= nflip;
+    *n_opp += nflip;
+    if (undo->jump) {
+        *own |= BB_BIT(undo->from);
+    } else {
+        *n_own -= 1;
+        bb->n_empty += 1;
+    }
+    bb->key  = undo->key;
+    bb->side = undo->side;
+}
+void bb_pass(BitBoard *bb) {
+    bb->side ^= 1;
+    bb->key ^= ZOBRIST_SIDE;
+}
+void bb_set_side(BitBoard *bb, char player) {
+    uint8_t side = (player == 'B');
+    if (bb->side != side) bb_pass(bb);
+}
+// 전체 재계산 (bb_from_board 및 검증용), 평소에는 bb_move 가 증분 갱신
+uint64_t bb_compute_key(const BitBoard *bb) {
+    uint64_t key = bb->side ? ZOBRIST_SIDE : 0;
+    for (uint64_t m = bb->red; m; m &= m - 1)      key ^= ZOBRIST_RED[bb_lsb(m)];
+    for (uint64_t m = bb->blue; m; m &= m - 1)     key ^= ZOBRIST_BLUE[bb_lsb(m)];
+    for (uint64_t m = bb->obstacle; m; m &= m - 1) key ^= ZOBRIST_OBSTACLE[bb_lsb(m)];
+    return key;
+}
+int bb_has_valid_move(const BitBoard *bb, char player) {
+    uint64_t own = bb_own(bb, player);
+    return ((bb_adjacent(own) | bb_jump_targets(own)) & bb_empty(bb)) != 0;
+}
+// 합법 수 전체. clone 은 결과가 같으므로 목적지마다 하나만(가장 낮은 출발지) 넣는다
+int generate_moves(const BitBoard *bb, char player, MoveList *list) {
+    uint64_t own = bb_own(bb, player);
+    uint64_t empty = bb_empty(bb);
+    int n = 0;
+
+    for (uint64_t t = bb_adjacent(own) & empty; t; t &= t - 1) {
+        int to = bb_lsb(t);
+        list->moves[n++] = MV_PACK(bb_lsb(BB_ADJ_MASK[to] & own), to, 0);
+    }
+    for (uint64_t o = own; o; o &= o - 1) {
+        int from = bb_lsb(o);
+        for (uint64_t t = BB_JUMP_MASK[from] & empty; t; t &= t - 1)
+            list->moves[n++] = MV_PACK(from, bb_lsb(t), 1);
+    }
+    list->count = n;
+    return n;
+}
+// O(1): 카운터만 확인
+int bb_is_game_over(const BitBoard *bb) {
+    if (bb->n_empty == 0) return 1;              // 빈칸 없음 (전부 돌/장애물 포함)
+    if (bb->n_red == 0 || bb->n_blue == 0) return 1;
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+//  목적지 일괄 평가 (DestScores)
+// -----------------------------------------------------------------------------
+// 1 비트짜리 보드 x 를 칸별 4 비트 카운터(bit-plane)에 더한다
+static inline void planes_add(uint64_t p[4], uint64_t x) {
+    for (int k = 0; k < 4 && x; k++) {
+        uint64_t carry = p[k] & x;
+        p[k] ^= x;
+        x = carry;
+    }
+}
+
+void bb_score_dests(const BitBoard *bb, char player, DestScores *ds) {
+    uint64_t own = bb_own(bb, player), opp = bb_opp(bb, player), empty = bb_empty(bb);
+    ds->clone = bb_adjacent(own) & empty;
+    ds->jump = bb_jump_targets(own) & empty & ~ds->clone;
+
+    // 상대 돌을 8 방향으로 한 칸씩 민 보드 = "그 방향 이웃이 상대 돌인 칸"
+    uint64_t p[4] = { 0, 0, 0, 0 };
+    planes_add(p, opp << 8);
+    planes_add(p, opp >> 8);
+    planes_add(p, (opp << 1) & ~BB_FILE_A);
+    planes_add(p, (opp >> 1) & ~BB_FILE_H);
+    planes_add(p, (opp << 9) & ~BB_FILE_A);
+    planes_add(p, (opp << 7) & ~BB_FILE_H);
+    planes_add(p, (opp >> 7) & ~BB_FILE_A);
+    planes_add(p, (opp >> 9) & ~BB_FILE_H);
+    planes_add(p, ds->clone);
+
+    uint64_t dests = ds->clone | ds->jump;
+    for (int k = 0; k < 4; k++) ds->gain[k] = p[k] & dests;
+}
+
+// gain 이 가장 큰 목적지 집합: 위 bit-plane 부터 켜진 칸이 있으면 그쪽으로 좁힌다
+uint64_t bb_best_dests(const DestScores *ds) {
+    uint64_t cand = ds->clone | ds->jump;
+    for (int k = 3; k >= 0; k--) {
+        uint64_t t = cand & ds->gain[k];
+        if (t) cand = t;
+    }
+    return cand;
+}
+
+// 목적지 하나에 대한 출발지 선택: clone 이 되면 clone (gain +1), 아니면 가장 낮은 jump 출발지
+PackedMove bb_dest_move(const BitBoard *bb, char player, const DestScores *ds, int to) {
+    uint64_t own = bb_own(bb, player);
+    if ((ds->clone >> to) & 1) return MV_PACK(bb_lsb(BB_ADJ_MASK[to] & own), to, 0);
+    if ((ds->jump >> to) & 1) return MV_PACK(bb_lsb(BB_JUMP_MASK[to] & own), to, 1);
+    return MV_NONE;
+}
+
+// 한 수 돌 이득 최대 (flip-count 봇), 둘 곳이 없으면 MV_NONE
+PackedMove bb_greedy_move(const BitBoard *bb, char player) {
+    DestScores ds;
+    bb_score_dests(bb, player, &ds);
+    uint64_t best = bb_best_dests(&ds);
+    return best ? bb_dest_move(bb, player, &ds, bb_lsb(best)) : MV_NONE;
+}
@@ -2,6 +2,7 @@
 #define GAME_H
 
 #include "server.h"
+#include "bitboard.h"
 
 #define IS_WS(ch)    ((ch)==' ' || (ch)=='\t' || (ch)=='\n' || \
                       (ch)=='\r' || (ch)=='\f' || (ch)=='\v')
@@ -11,6 +12,48 @@ static const int directions[8][2] = {
     {-1, -1}, {-1,  1}, { 1, -1}, { 1,  1}
 };
 
+// 16-bit 수 표현: from(6) | to(6) << 6 | jump(1) << 12, 0 은 "수 없음"(pass)
+typedef uint16_t PackedMove;
+#define MV_PACK(from, to, jump) ((PackedMove)((from) | ((to) << 6) | ((jump) << 12)))
+#define MV_FROM(m)  ((m) & 63)
+#define MV_TO(m)    (((m) >> 6) & 63)
+#define MV_JUMP(m)  (((m) >> 12) & 1)
+#define MV_NONE     ((PackedMove)0)
+
+// clone 은 목적지당 하나(64) + jump 가능한 (from,to) 쌍 최대 168
+#define MAX_MOVES   232
+typedef struct {
+    int count;
+    PackedMove moves[MAX_MOVES];
+} MoveList;
+
+// make_move 가 남기는 되돌리기 기록 (unmake_move 로 보드 복사 없이 복원)
+typedef struct {
+    uint64_t flips;     // 뒤집힌 상대 돌
+    uint64_t key;       // 이전 Zobrist 키
+    uint8_t  from;
+    uint8_t  to;
+    uint8_t  jump;      // 1 이면 from 이 비워졌음
+    uint8_t  side;      // 이전 둘 차례
+} MoveUndo;
+
+/*
+ * 64 칸 목적지 일괄 평가. (from, to) 쌍마다 세지 않고 neighbor fill 8 번을
+ * bit-sliced 덧셈으로 합쳐서 모든 칸의 돌 이득을 한 번에 만든다.
+ * gain = 뒤집히는 상대 돌 수 + (clone 이면 새 돌 1), 칸 sq 의 값은 bb_dest_gain.
+ */
+typedef struct {
+    uint64_t clone;      // 복제로 갈 수 있는 빈칸
+    uint64_t jump;       // jump 로만 갈 수 있는 빈칸 (clone 과 겹치지 않음)
+    uint64_t gain[4];    // 칸별 gain (0..9) 의 bit-plane, 목적지가 아닌 칸은 0
+} DestScores;
+
+static inline int bb_dest_gain(const DestScores *ds, int sq) {
+    return (int)((ds->gain[0] >> sq) & 1) | (int)((ds->gain[1] >> sq) & 1) << 1 |
+           (int)((ds->gain[2] >> sq) & 1) << 2 | (int)((ds->gain[3] >> sq) & 1) << 3;
+}
+
+void init_board(char board[BOARD_SIZE][BOARD_SIZE]);
 int readCoordinates(int *r1, int *c1, int *r2, int *c2);
 int isValidInput(char board[BOARD_SIZE][BOARD_SIZE],
                  int r1, int c1,
@@ -32,4 +75,24 @@ int countB(char board[BOARD_SIZE][BOARD_SIZE]);
 int countObstacle(char board[BOARD_SIZE][BOARD_SIZE]);
 void printResult(char board[BOARD_SIZE][BOARD_SIZE]);
 
+// bitboard rules core (char-board functions above are adapters over these)
+void bb_from_board(BitBoard *bb, char board[BOARD_SIZE][BOARD_SIZE]);
+void bb_to_board(const BitBoard *bb, char board[BOARD_SIZE][BOARD_SIZE]);
+int bb_from_rows(BitBoard *bb, const char *const rows[BOARD_SIZE]);
+int bb_is_legal_move(const BitBoard *bb, char player, int from, int to);
+uint64_t bb_flips(const BitBoard *bb, char player, int to);
+int bb_move(BitBoard *bb, char player, int from, int to);
+int make_move(BitBoard *bb, char player, int from, int to, MoveUndo *undo);
+void unmake_move(BitBoard *bb, const MoveUndo *undo);
+void bb_pass(BitBoard *bb);
+void bb_set_side(BitBoard *bb, char player);
+uint64_t bb_compute_key(const BitBoard *bb);
+int bb_has_valid_move(const BitBoard *bb, char player);
+int generate_moves(const BitBoard *bb, char player, MoveList *list);
+int bb_is_game_over(const BitBoard *bb);
+void bb_score_dests(const BitBoard *bb, char player, DestScores *ds);
+uint64_t bb_best_dests(const DestScores *ds);
+PackedMove bb_dest_move(const BitBoard *bb, char player, const DestScores *ds, int to);
+PackedMove bb_greedy_move(const BitBoard *bb, char player);
+
 #endif
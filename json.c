@@ -1,47 +1,284 @@
 #include "../include/json.h"
 #include <string.h>
+#include <errno.h>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <stdlib.h>
 
-int send_json(int sockfd, const cJSON *json_msg)
+// ------------------------------------------------------------
+// JsonReader: 줄 단위 입력 ring buffer
+// ------------------------------------------------------------
+int json_reader_init(JsonReader *r, size_t max_msg)
 {
-    char *json_str = cJSON_PrintUnformatted((cJSON*)json_msg);
-    if (!json_str) return -1;
-    size_t len = strlen(json_str);
-    if (send(sockfd, json_str, len, 0) != (ssize_t)len) {
-        free(json_str);
+    memset(r, 0, sizeof(*r));
+    r->max_msg = max_msg ? max_msg : JSON_MAX_MSG;
+    r->cap = JSON_READER_INIT;
+    r->buf = (char *)malloc(r->cap);
+    return r->buf ? 0 : -1;
+}
+
+void json_reader_free(JsonReader *r)
+{
+    free(r->buf);
+    free(r->scratch);
+    memset(r, 0, sizeof(*r));
+}
+
+// 버퍼가 꽉 찼을 때 두 배로 키우면서 내용을 앞으로 펴 둔다 (여기서만 복사가 일어남)
+static int reader_grow(JsonReader *r)
+{
+    size_t used = r->tail - r->head;
+    size_t cap = r->cap * 2;
+    char *buf = (char *)malloc(cap);
+    if (!buf) return -1;
+
+    size_t start = r->head & (r->cap - 1);
+    size_t first = used < r->cap - start ? used : r->cap - start;
+    memcpy(buf, r->buf + start, first);
+    memcpy(buf + first, r->buf, used - first);
+
+    free(r->buf);
+    free(r->scratch);  // 다음 경계 메시지 때 새 크기로 다시 잡는다
+    r->scratch = NULL;
+    r->buf = buf;
+    r->cap = cap;
+    r->scan -= r->head;
+    r->head = 0;
+    r->tail = used;
+    return 0;
+}
+
+/*
+ * recv 한 번(readv)으로 ring 의 빈 공간(최대 두 조각)을 채운다.
+ * 반환값은 recv 와 같다: 읽은 바이트 수, 0 = 연결 종료, -1 = 오류 (errno, 비차단 소켓이면 EAGAIN 가능).
+ * 메시지 하나가 max_msg 를 넘으면 errno = EMSGSIZE 로 -1.
+ */
+ssize_t json_reader_fill(JsonReader *r, int sockfd)
+{
+    if (r->error) {
+        errno = EMSGSIZE;
         return -1;
     }
-    free(json_str);
-    if (send(sockfd, "\n", 1, 0) != 1)
-        return -1;
-    return 0;
+    if (r->tail - r->head == r->cap) {
+        if (r->cap >= r->max_msg) {
+            r->error = 1;
+            errno = EMSGSIZE;
+            return -1;
+        }
+        if (reader_grow(r) < 0) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+
+    size_t space = r->cap - (r->tail - r->head);
+    size_t off = r->tail & (r->cap - 1);
+    struct iovec iov[2];
+    int iovcnt = 1;
+    iov[0].iov_base = r->buf + off;
+    iov[0].iov_len = space < r->cap - off ? space : r->cap - off;
+    if (iov[0].iov_len < space) {
+        iov[1].iov_base = r->buf;
+        iov[1].iov_len = space - iov[0].iov_len;
+        iovcnt = 2;
+    }
+
+    ssize_t n = readv(sockfd, iov, iovcnt);
+    if (n > 0) r->tail += n;
+    return n;
 }
 
-cJSON *recv_json(int sockfd)
+/*
+ * 완성된 줄 하나를 꺼내 파싱한다. 줄이 없으면 NULL, *has_line = 0.
+ * 줄은 있었지만 JSON 이 깨졌으면 NULL, *has_line = 1 (그 줄은 버려짐).
+ * scan 이전은 다시 훑지 않으므로 조각조각 도착하는 긴 메시지도 전체를 한 번만 훑는다.
+ */
+cJSON *json_reader_next(JsonReader *r, int *has_line)
 {
-    enum { BUF_SIZE = 4096 };
-    static char buf[BUF_SIZE];
-    static size_t buf_len = 0;
+    size_t mask = r->cap - 1;
+    *has_line = 0;
 
-    while (1) {
-        char *newline = (char *)memchr(buf, '\n', buf_len);
-        if (newline) {
-            size_t msg_len = newline - buf;
-            buf[msg_len] = '\0';
-            cJSON *msg = cJSON_Parse(buf);
-
-            size_t used = msg_len + 1;
-            memmove(buf, buf + used, buf_len - used);
-            buf_len -= used;
-            return msg;
+    while (r->scan < r->tail) {
+        size_t off = r->scan & mask;
+        size_t len = r->tail - r->scan;
+        if (len > r->cap - off) len = r->cap - off;  // ring 끝에서 한 번 끊어 훑는다
+        const char *nl = (const char *)memchr(r->buf + off, '\n', len);
+        if (!nl) {
+            r->scan += len;
+            continue;
         }
 
-        if (buf_len + 1 >= BUF_SIZE) return NULL; 
-        ssize_t n = recv(sockfd, buf + buf_len, BUF_SIZE - buf_len - 1, 0);
+        size_t end = r->scan + (size_t)(nl - (r->buf + off));  // '\n' 의 절대 위치
+        size_t msg_len = end - r->head;
+        if (msg_len + 1 > r->max_msg) {
+            r->error = 1;
+            return NULL;
+        }
+
+        size_t start = r->head & mask;
+        const char *msg = r->buf + start;
+        if (start + msg_len > r->cap) {
+            // ring 경계에 걸친 메시지만 scratch 에 이어 붙인다
+            if (!r->scratch && !(r->scratch = (char *)malloc(r->cap))) {
+                r->error = 1;
+                return NULL;
+            }
+            size_t first = r->cap - start;
+            memcpy(r->scratch, r->buf + start, first);
+            memcpy(r->scratch + first, r->buf, msg_len - first);
+            msg = r->scratch;
+        }
+
+        cJSON *json = cJSON_ParseWithLength(msg, msg_len);
+        r->head = r->scan = end + 1;
+        *has_line = 1;
+        return json;
+    }
+
+    if (r->scan - r->head >= r->max_msg) r->error = 1;
+    return NULL;
+}
+
+// 차단 소켓용: 줄 하나가 완성될 때까지 읽는다 (클라이언트 쪽)
+cJSON *recv_json(JsonReader *r, int sockfd)
+{
+    while (1) {
+        int has_line;
+        cJSON *msg = json_reader_next(r, &has_line);
+        if (has_line || r->error) return msg;
+
+        ssize_t n = json_reader_fill(r, sockfd);
+        if (n < 0 && errno == EINTR) continue;
         if (n <= 0) return NULL;
-        buf_len += n;
-        buf[buf_len] = '\0';
     }
 }
+
+// ------------------------------------------------------------
+// JsonWriter: 메시지당 할당 없이, 시스템 콜 한 번으로 보내기
+// ------------------------------------------------------------
+void json_writer_init(JsonWriter *w, size_t max_msg)
+{
+    w->buf = NULL;          // 첫 send_json 때 할당
+    w->cap = 0;
+    w->max_msg = max_msg ? max_msg : JSON_MAX_MSG;
+}
+
+void json_writer_free(JsonWriter *w)
+{
+    free(w->buf);
+    w->buf = NULL;
+    w->cap = 0;
+}
+
+// 짧게 써지면(partial write) 남은 부분을 이어서 보낸다. 차단 소켓용.
+int json_send_all(int sockfd, const char *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = send(sockfd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// 한 줄짜리 메시지가 Nagle 에 묶여 delayed ACK 만큼 늦지 않도록
+int json_set_nodelay(int sockfd)
+{
+    int yes = 1;
+    return setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+}
+
+// w->buf 에 '\n' 으로 끝나는 한 줄을 찍고 길이를 돌려준다 (실패하면 -1)
+static ssize_t writer_print(JsonWriter *w, const cJSON *json_msg)
+{
+    while (1) {
+        // 끝의 한 칸은 '\n' 자리, cJSON 은 숫자 출력에 5 바이트 여유를 요구한다
+        if (w->cap >= 8 &&
+            cJSON_PrintPreallocated((cJSON *)json_msg, w->buf, (int)(w->cap - 1), 0))
+            break;
+        size_t cap = w->cap ? w->cap * 2 : JSON_WRITER_INIT;
+        if (w->cap >= w->max_msg) return -1;
+        char *buf = (char *)realloc(w->buf, cap);
+        if (!buf) return -1;
+        w->buf = buf;
+        w->cap = cap;
+    }
+    size_t len = strlen(w->buf);
+    w->buf[len++] = '\n';
+    return (ssize_t)len;
+}
+
+int send_json(JsonWriter *w, int sockfd, const cJSON *json_msg)
+{
+    ssize_t len = writer_print(w, json_msg);
+    if (len < 0) return -1;
+    return json_send_all(sockfd, w->buf, (size_t)len);
+}
+
+// ------------------------------------------------------------
+// JsonMsg: 직렬화 한 번, 참조 카운트로 공유, 다 쓴 버퍼는 encoder 가 재사용
+// ------------------------------------------------------------
+void json_encoder_init(JsonEncoder *e, size_t max_msg)
+{
+    e->spare = NULL;
+    e->size_hint = JSON_WRITER_INIT;
+    e->max_msg = max_msg ? max_msg : JSON_MAX_MSG;
+}
+
+void json_encoder_free(JsonEncoder *e)
+{
+    free(e->spare);
+    e->spare = NULL;
+}
+
+static JsonMsg *msg_alloc(size_t cap)
+{
+    JsonMsg *msg = (JsonMsg *)malloc(sizeof(JsonMsg) + cap);
+    if (!msg) return NULL;
+    msg->cap = cap;
+    msg->data = (char *)(msg + 1);
+    return msg;
+}
+
+JsonMsg *json_msg_encode(JsonEncoder *e, const cJSON *json_msg)
+{
+    JsonMsg *msg = e->spare;
+    e->spare = NULL;
+    if (!msg && !(msg = msg_alloc(e->size_hint))) return NULL;
+
+    // 끝의 한 칸은 '\n' 자리, cJSON 은 숫자 출력에 5 바이트 여유를 요구한다
+    while (!cJSON_PrintPreallocated((cJSON *)json_msg, msg->data, (int)(msg->cap - 1), 0)) {
+        JsonMsg *bigger = NULL;
+        if (msg->cap < e->max_msg)
+            bigger = (JsonMsg *)realloc(msg, sizeof(JsonMsg) + msg->cap * 2);
+        if (!bigger) {
+            e->spare = msg;
+            return NULL;
+        }
+        msg = bigger;
+        msg->cap *= 2;
+        msg->data = (char *)(msg + 1);
+    }
+    if (msg->cap > e->size_hint) e->size_hint = msg->cap;
+
+    msg->len = strlen(msg->data);
+    msg->data[msg->len++] = '\n';
+    msg->refs = 1;
+    msg->owner = e;
+    return msg;
+}
+
+void json_msg_unref(JsonMsg *msg)
+{
+    if (!msg || --msg->refs > 0) return;
+    // 마지막 참조: encoder 에 spare 가 없으면 다음 encode 가 이 버퍼에 찍는다
+    if (!msg->owner->spare) msg->owner->spare = msg;
+    else free(msg);
+}
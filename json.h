@@ -1,9 +1,88 @@
 #ifndef JSON_UTIL_H
 #define JSON_UTIL_H
 
+#include <stddef.h>
+#include <sys/types.h>
 #include "../libs/cJSON.h"
 
-int send_json(int sockfd, const cJSON *json_msg);
-cJSON *recv_json(int sockfd);
+#define JSON_READER_INIT  4096        // 처음 잡는 입력 버퍼
+#define JSON_MAX_MSG      (64 * 1024) // 기본 최대 메시지 크기 (줄바꿈 포함)
+#define JSON_WRITER_INIT  1024        // 출력 버퍼 첫 크기 (보드 포함 메시지가 들어가는 정도)
 
-#endif
\ No newline at end of file
+/*
+ * 접속별 줄 단위(JSON 한 줄 = 메시지 하나) 입력 ring buffer.
+ * head/tail/scan 은 계속 증가하는 절대 위치이고 실제 칸은 & (cap - 1).
+ *   [head, scan) : 이미 '\n' 이 없다고 확인한 부분 (다시 훑지 않음)
+ *   [scan, tail) : 아직 안 훑은 수신 데이터
+ * 메시지는 버퍼 안에서 바로 파싱하고, ring 경계에 걸친 메시지만 scratch 로 복사한다.
+ * 한 메시지가 버퍼를 다 채우면 max_msg 까지 두 배씩 키운다.
+ */
+typedef struct {
+    char *buf;
+    char *scratch;       // 경계에 걸친 메시지용 (필요할 때 max_msg 로 할당)
+    size_t cap;          // 2 의 거듭제곱
+    size_t max_msg;
+    size_t head, scan, tail;
+    int error;           // 메시지가 max_msg 를 넘음, 이후 읽기 불가
+} JsonReader;
+
+int json_reader_init(JsonReader *r, size_t max_msg);
+void json_reader_free(JsonReader *r);
+ssize_t json_reader_fill(JsonReader *r, int sockfd);
+cJSON *json_reader_next(JsonReader *r, int *has_line);
+
+/*
+ * 접속별 출력 버퍼. cJSON_PrintPreallocated 로 여기에 바로 찍고 '\n' 까지 붙여
+ * send 한 번으로 보낸다. 모자라면 max_msg 까지 두 배씩 키우고, 이후로는 재사용.
+ */
+typedef struct {
+    char *buf;
+    size_t cap;
+    size_t max_msg;
+} JsonWriter;
+
+void json_writer_init(JsonWriter *w, size_t max_msg);
+void json_writer_free(JsonWriter *w);
+int json_send_all(int sockfd, const char *data, size_t len);
+int json_set_nodelay(int sockfd);
+
+int send_json(JsonWriter *w, int sockfd, const cJSON *json_msg);
+
+/*
+ * 한 번 직렬화해서 여러 접속의 출력 큐에 같이 거는 메시지 (끝의 '\n' 포함).
+ * 만든 뒤로는 읽기 전용이고, 마지막 참조가 풀리면 만든 encoder 의 spare 로 돌아간다.
+ * (서버는 스레드 하나)
+ */
+typedef struct {
+    int refs;
+    size_t len;
+    size_t cap;
+    struct JsonEncoder *owner;
+    char *data;          // 구조체 바로 뒤에 붙어 있음
+} JsonMsg;
+
+/*
+ * JsonMsg 를 만드는 쪽. cJSON_PrintPreallocated 로 spare 메시지 버퍼에 바로 찍으므로
+ * 평소에는 할당도 복사도 없다. spare 가 없으면(이전 메시지가 아직 큐에 있으면)
+ * 지금까지 쓴 가장 큰 크기로 새로 잡는다.
+ */
+typedef struct JsonEncoder {
+    JsonMsg *spare;
+    size_t size_hint;
+    size_t max_msg;
+} JsonEncoder;
+
+void json_encoder_init(JsonEncoder *e, size_t max_msg);
+void json_encoder_free(JsonEncoder *e);
+JsonMsg *json_msg_encode(JsonEncoder *e, const cJSON *json_msg);
+void json_msg_unref(JsonMsg *msg);
+
+static inline JsonMsg *json_msg_ref(JsonMsg *msg)
+{
+    msg->refs++;
+    return msg;
+}
+
+cJSON *recv_json(JsonReader *r, int sockfd);
+
+#endif
@@ -4,12 +4,20 @@
 #include "server.h"
 #include "client.h"
 #include "board.h"
+#include "tt.h"
+#include "search.h"
+#include "mcts.h"
+#include "book.h"
+#include "pattern.h"
+#include "nnue.h"
 
 
 void print_usage(const char *prog) {
     printf("Usage:\n");
     printf("  %s server -p <port>\n", prog);
-    printf("  %s client -i <ip> -p <port> -u <username>\n", prog);
+    printf("  %s client -i <ip> -p <port> -u <username> [-t <threads>] [--hash <MB>] [--huge-pages] [--ponder]\n", prog);
+    printf("         [-e ab|mcts|flip] [--tree <MB>] [--endgame <empties>] [--book <file>]\n");
+    printf("         [--eval simple|pattern|nnue] [--patterns <file>] [--nnue <file>]\n");
 }
 
 int main(int argc, char *argv[]) {
@@ -44,6 +52,15 @@ int main(int argc, char *argv[]) {
         int port = 8080;
 	    char port_str[16];
         char *username = NULL;
+        int hash_mb = TT_DEFAULT_MB;
+        int huge_pages = 0;
+        int threads = 1;
+        int tree_mb = MCTS_DEFAULT_MB;
+        int engine = ENGINE_ALPHABETA;
+        const char *book_path = NULL;
+        const char *pattern_path = NULL;
+        const char *nnue_path = NULL;
+        int eval = EVAL_SIMPLE;
 
         for (int i = 2; i < argc; ++i) {
             if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
@@ -52,12 +69,69 @@ int main(int argc, char *argv[]) {
                 port = atoi(argv[++i]);
             else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc)
                 username = argv[++i];
+            else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+                threads = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc)
+                hash_mb = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--huge-pages") == 0)
+                huge_pages = 1;
+            else if (strcmp(argv[i], "--ponder") == 0)
+                client_set_ponder(1);
+            else if (strcmp(argv[i], "--eval") == 0 && i + 1 < argc) {
+                const char *e = argv[++i];
+                eval = strcmp(e, "pattern") == 0 ? EVAL_PATTERN
+                     : strcmp(e, "nnue") == 0    ? EVAL_NNUE : EVAL_SIMPLE;
+            }
+            else if (strcmp(argv[i], "--patterns") == 0 && i + 1 < argc) {
+                pattern_path = argv[++i];
+                eval = EVAL_PATTERN;
+            }
+            else if (strcmp(argv[i], "--nnue") == 0 && i + 1 < argc) {
+                nnue_path = argv[++i];
+                eval = EVAL_NNUE;
+            }
+            else if (strcmp(argv[i], "--book") == 0 && i + 1 < argc)
+                book_path = argv[++i];
+            else if (strcmp(argv[i], "--endgame") == 0 && i + 1 < argc)
+                client_set_endgame(atoi(argv[++i]));
+            else if (strcmp(argv[i], "--tree") == 0 && i + 1 < argc)
+                tree_mb = atoi(argv[++i]);
+            else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+                const char *e = argv[++i];
+                if (strcmp(e, "mcts") == 0)      engine = ENGINE_MCTS;
+                else if (strcmp(e, "flip") == 0) engine = ENGINE_FLIP;
+                else                             engine = ENGINE_ALPHABETA;
+            }
         }
     	snprintf(port_str, sizeof(port_str),"%d", port);
         if (!ip || !username) {
             print_usage(argv[0]);
             return EXIT_FAILURE;
         }
+        client_set_engine(engine);
+        search_set_threads(threads);
+        if (pattern_path && pattern_load(pattern_path) < 0) {
+            fprintf(stderr, "Failed to load pattern weights %s.\n", pattern_path);
+            return EXIT_FAILURE;
+        }
+        if (nnue_path && nnue_load(nnue_path) < 0) {
+            fprintf(stderr, "Failed to load nnue weights %s.\n", nnue_path);
+            return EXIT_FAILURE;
+        }
+        if (search_set_eval(eval) < 0) return EXIT_FAILURE;
+        mcts_set_threads(threads);
+        // MCTS 트리는 mcts 엔진일 때만 잡는다 (ab/flip 은 TT 만 쓴다)
+        if (engine == ENGINE_MCTS && tree_mb > 0 && mcts_init((size_t)tree_mb) < 0) {
+            fprintf(stderr, "Failed to allocate %d MB MCTS tree.\n", tree_mb);
+            return EXIT_FAILURE;
+        }
+        if (hash_mb > 0 && tt_init((size_t)hash_mb, huge_pages) < 0) {
+            fprintf(stderr, "Failed to allocate %d MB transposition table.\n", hash_mb);
+            return EXIT_FAILURE;
+        }
+        // 북이 없거나 깨졌으면 경고만 하고 북 없이 진행
+        if (book_path && book_open(book_path) == 0)
+            printf("Opening book: %zu positions\n", book_size());
         if (init_led_matrix(&argc, &argv) < 0) {
             fprintf(stderr, "Failed to initialize LED Matrix.\n");
             return EXIT_FAILURE;
@@ -65,6 +139,9 @@ int main(int argc, char *argv[]) {
 
         int ret = client_run(ip, port_str, username);
         close_led_matrix();
+        tt_free();
+        mcts_free();
+        book_close();
         return ret;
 
     } else {
@@ -0,0 +1,350 @@
+#include "../include/mcts.h"
+#include "../include/search.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#define MCTS_CHECK_EVERY    63     // playout 64 번마다 시계/중단 플래그 확인
+#define MCTS_EXPAND_VISITS  4      // 이만큼 방문된 leaf 만 확장 (pool 절약)
+#define MCTS_MAX_PATH       256
+#define MCTS_ROLLOUT_PLIES  160    // 이 이상이면 그 시점 돌 수로 판정
+#define MCTS_UCT_C          0.7f
+
+// -----------------------------------------------------------------------------
+//  Node pool: 두 개를 번갈아 쓴다. 턴이 바뀌면 살아남은 subtree 를 반대쪽으로 복사
+// -----------------------------------------------------------------------------
+static MctsNode *pool[2] = { NULL, NULL };
+static uint32_t pool_cap = 0;
+static uint32_t pool_used = 0;
+static int cur = 0;
+
+static BitBoard tree_pos;          // pool[cur][0] 의 국면 (side 설정됨)
+static int tree_valid = 0;
+static int mcts_threads = 1;
+
+typedef struct {
+    pthread_t tid;
+    uint64_t rng;
+    uint64_t playouts;
+    const MctsLimits *limits;
+    int *abort_flag;
+    uint64_t *total;
+} Worker;
+
+int mcts_init(size_t mb) {
+    mcts_free();
+    size_t n = ((mb ? mb : 1) << 20) / 2 / sizeof(MctsNode);
+    if (n > 0x7FFFFFFF) n = 0x7FFFFFFF;
+    pool[0] = (MctsNode *)malloc(n * sizeof(MctsNode));
+    pool[1] = (MctsNode *)malloc(n * sizeof(MctsNode));
+    if (!pool[0] || !pool[1]) {
+        perror("malloc");
+        mcts_free();
+        return -1;
+    }
+    pool_cap = (uint32_t)n;
+    return 0;
+}
+
+void mcts_free(void) {
+    free(pool[0]);
+    free(pool[1]);
+    pool[0] = pool[1] = NULL;
+    pool_cap = pool_used = 0;
+    tree_valid = 0;
+}
+
+void mcts_set_threads(int n) {
+    if (n < 1) n = 1;
+    if (n > MCTS_MAX_THREADS) n = MCTS_MAX_THREADS;
+    mcts_threads = n;
+}
+
+static inline void init_node(MctsNode *n, PackedMove mv) {
+    n->first_child = -1;
+    n->visits = 0;
+    n->wins = 0;
+    n->move = mv;
+    n->n_children = 0;
+    n->state = MCTS_LEAF;
+}
+
+static void reset_tree(const BitBoard *pos) {
+    init_node(&pool[cur][0], MV_NONE);
+    pool_used = 1;
+    tree_pos = *pos;
+    tree_valid = 1;
+}
+
+static inline void apply_move(BitBoard *bb, PackedMove mv) {
+    if (mv == MV_NONE) bb_pass(bb);
+    else bb_move(bb, bb_side(bb), MV_FROM(mv), MV_TO(mv));
+}
+
+static inline int same_position(const BitBoard *a, const BitBoard *b) {
+    return a->key == b->key && a->red == b->red && a->blue == b->blue && a->side == b->side;
+}
+
+// 이전 root 에서 (내 수, 상대 수) 두 단계 안에 pos 가 있으면 그 노드 번호, 없으면 -1
+static int find_reuse(const BitBoard *pos) {
+    if (!tree_valid) return -1;
+    const MctsNode *nodes = pool[cur];
+    if (same_position(&tree_pos, pos)) return 0;
+    if (nodes[0].state != MCTS_EXPANDED) return -1;
+
+    for (int i = 0; i < nodes[0].n_children; i++) {
+        const MctsNode *c = &nodes[nodes[0].first_child + i];
+        if (c->state != MCTS_EXPANDED) continue;
+        BitBoard bb = tree_pos;
+        apply_move(&bb, c->move);
+        for (int j = 0; j < c->n_children; j++) {
+            int g = c->first_child + j;
+            BitBoard bb2 = bb;
+            apply_move(&bb2, nodes[g].move);
+            if (same_position(&bb2, pos)) return g;
+        }
+    }
+    return -1;
+}
+
+/*
+ * src 노드를 root 로 하는 subtree 를 반대쪽 pool 에 BFS 순서로 복사.
+ * 복사된 노드의 first_child 는 처리될 때까지 원래 pool 의 번호를 들고 있다.
+ * 공간이 모자라면 거기서부터는 미확장 leaf 로 남긴다.
+ */
+static void reroot(int src) {
+    const MctsNode *from = pool[cur];
+    MctsNode *to = pool[cur ^ 1];
+    uint32_t used = 1;
+    to[0] = from[src];
+    for (uint32_t i = 0; i < used; i++) {
+        MctsNode *n = &to[i];
+        if (n->state != MCTS_EXPANDED) continue;
+        uint32_t cnt = n->n_children;
+        if (used + cnt > pool_cap) {
+            n->first_child = -1;
+            n->n_children = 0;
+            n->state = MCTS_LEAF;
+            continue;
+        }
+        memcpy(&to[used], &from[n->first_child], cnt * sizeof(MctsNode));
+        n->first_child = (int32_t)used;
+        used += cnt;
+    }
+    cur ^= 1;
+    pool_used = used;
+}
+
+// -----------------------------------------------------------------------------
+//  Playout
+// -----------------------------------------------------------------------------
+static inline uint64_t next_rand(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x >> 12; x ^= x << 25; x ^= x >> 27;
+    *s = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// mask 에서 무작위 비트 하나 (mask != 0)
+static inline int random_bit(uint64_t mask, uint64_t *rng) {
+    int k = (int)((next_rand(rng) >> 32) % (uint64_t)bb_popcount(mask));
+    while (k--) mask &= mask - 1;
+    return bb_lsb(mask);
+}
+
+/*
+ * MoveList 없이 bitboard 에서 바로 수를 뽑는 rollout.
+ * semi-greedy: 목적지 두 개를 무작위로 뽑아 이득(뒤집는 수 + clone 이면 1)이 큰 쪽을 둔다.
+ * 반환값: 이긴 쪽 'R' / 'B', 무승부 0
+ */
+static char rollout(BitBoard *bb, uint64_t *rng) {
+    for (int ply = 0; ply < MCTS_ROLLOUT_PLIES && !bb_is_game_over(bb); ply++) {
+        char me = bb_side(bb);
+        uint64_t own = bb_own(bb, me), opp = bb_opp(bb, me), empty = bb_empty(bb);
+        uint64_t clone_t = bb_adjacent(own) & empty;
+        uint64_t targets = clone_t | (bb_jump_targets(own) & empty);
+        if (!targets) {
+            if (!bb_has_valid_move(bb, me == 'R' ? 'B' : 'R')) break;
+            bb_pass(bb);
+            continue;
+        }
+        int a = random_bit(targets, rng), b = random_bit(targets, rng);
+        int ga = bb_popcount(BB_FLIP_MASK[a] & opp) + (int)((clone_t >> a) & 1);
+        int gb = bb_popcount(BB_FLIP_MASK[b] & opp) + (int)((clone_t >> b) & 1);
+        int to = gb > ga ? b : a;
+        int from = (clone_t & BB_BIT(to)) ? bb_lsb(BB_ADJ_MASK[to] & own)
+                                          : random_bit(BB_JUMP_MASK[to] & own, rng);
+        bb_move(bb, me, from, to);
+    }
+    int diff = (int)bb->n_red - (int)bb->n_blue;
+    return diff > 0 ? 'R' : diff < 0 ? 'B' : 0;
+}
+
+// 한 스레드만 확장하고, 나머지는 확장이 끝날 때까지 이 노드에서 바로 rollout
+static void try_expand(MctsNode *n, const BitBoard *bb) {
+    uint8_t expect = MCTS_LEAF;
+    if (!__atomic_compare_exchange_n(&n->state, &expect, MCTS_EXPANDING, 0,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return;
+
+    char me = bb_side(bb);
+    MoveList list;
+    int cnt = generate_moves(bb, me, &list);
+    if (cnt == 0) {
+        if (bb_is_game_over(bb) || !bb_has_valid_move(bb, me == 'R' ? 'B' : 'R')) {
+            __atomic_store_n(&n->state, MCTS_TERMINAL, __ATOMIC_RELEASE);
+            return;
+        }
+        list.moves[0] = MV_NONE;   // pass 가 유일한 자식
+        cnt = 1;
+    }
+
+    uint32_t base = __atomic_fetch_add(&pool_used, (uint32_t)cnt, __ATOMIC_RELAXED);
+    if (base + (uint32_t)cnt > pool_cap) {
+        __atomic_store_n(&n->state, MCTS_LEAF, __ATOMIC_RELEASE);
+        return;
+    }
+    MctsNode *children = &pool[cur][base];
+    for (int i = 0; i < cnt; i++) init_node(&children[i], list.moves[i]);
+    n->first_child = (int32_t)base;
+    n->n_children = (uint8_t)cnt;
+    __atomic_store_n(&n->state, MCTS_EXPANDED, __ATOMIC_RELEASE);
+}
+
+// UCT. 방문 수는 내려가면서 먼저 올리므로(virtual loss) 다른 스레드는 같은 가지를 덜 고른다
+static int select_child(const MctsNode *nodes, const MctsNode *n) {
+    float log_n = logf((float)__atomic_load_n(&n->visits, __ATOMIC_RELAXED) + 1.0f);
+    int best = n->first_child;
+    float best_u = -1.0f;
+    for (int i = 0; i < n->n_children; i++) {
+        const MctsNode *c = &nodes[n->first_child + i];
+        int v = __atomic_load_n(&c->visits, __ATOMIC_RELAXED);
+        if (v == 0) return n->first_child + i;
+        int w = __atomic_load_n(&c->wins, __ATOMIC_RELAXED);
+        float u = (float)w / (2.0f * v) + MCTS_UCT_C * sqrtf(log_n / v);
+        if (u > best_u) { best_u = u; best = n->first_child + i; }
+    }
+    return best;
+}
+
+static void playout(Worker *w) {
+    MctsNode *nodes = pool[cur];
+    BitBoard bb = tree_pos;
+    int path[MCTS_MAX_PATH];
+    char mover[MCTS_MAX_PATH];
+    int len = 0, idx = 0;
+
+    __atomic_fetch_add(&nodes[0].visits, 1, __ATOMIC_RELAXED);
+    path[len] = 0; mover[len] = 0; len++;
+
+    while (len < MCTS_MAX_PATH) {
+        MctsNode *n = &nodes[idx];
+        int st = __atomic_load_n(&n->state, __ATOMIC_ACQUIRE);
+        if (st == MCTS_LEAF && __atomic_load_n(&n->visits, __ATOMIC_RELAXED) >= MCTS_EXPAND_VISITS) {
+            try_expand(n, &bb);
+            st = __atomic_load_n(&n->state, __ATOMIC_ACQUIRE);
+        }
+        if (st != MCTS_EXPANDED) break;
+
+        idx = select_child(nodes, n);
+        __atomic_fetch_add(&nodes[idx].visits, 1, __ATOMIC_RELAXED);
+        mover[len] = bb_side(&bb);
+        path[len] = idx;
+        len++;
+        apply_move(&bb, nodes[idx].move);
+    }
+
+    char winner = rollout(&bb, &w->rng);
+    for (int i = 1; i < len; i++) {
+        int reward = winner == 0 ? 1 : (winner == mover[i] ? 2 : 0);
+        if (reward) __atomic_fetch_add(&nodes[path[i]].wins, reward, __ATOMIC_RELAXED);
+    }
+}
+
+static void *worker_main(void *arg) {
+    Worker *w = (Worker *)arg;
+    const MctsLimits *limits = w->limits;
+    for (;;) {
+        if ((w->playouts & MCTS_CHECK_EVERY) == 0 &&
+            (search_now() >= limits->deadline ||
+             __atomic_load_n(w->abort_flag, __ATOMIC_RELAXED) ||
+             (limits->stop && __atomic_load_n(limits->stop, __ATOMIC_RELAXED))))
+            break;
+        if (limits->max_playouts &&
+            __atomic_fetch_add(w->total, 1, __ATOMIC_RELAXED) >= limits->max_playouts)
+            break;
+        playout(w);
+        w->playouts++;
+    }
+    return NULL;
+}
+
+/*
+ * tree parallel UCT: 모든 스레드가 하나의 트리를 공유하고 잠금 없이 atomic 으로 갱신.
+ * 이전 호출의 트리에 지금 국면이 있으면 그 subtree 를 root 로 이어서 쓴다.
+ * 반환값: 둘 수 있는 수가 있으면 1, pass 면 0
+ */
+int mcts_search(const BitBoard *root, char player,
+                const MctsLimits *limits, MctsResult *result) {
+    BitBoard bb = *root;
+    bb_set_side(&bb, player);
+    memset(result, 0, sizeof(*result));
+    double start = search_now();
+
+    MoveList list;
+    int n = generate_moves(&bb, player, &list);
+    if (n == 0) {
+        tree_valid = 0;
+        return 0;
+    }
+    result->best = list.moves[0];
+    if (n == 1) return 1;
+    if (!pool[0] && mcts_init(MCTS_DEFAULT_MB) < 0) return 1;
+
+    int reuse = find_reuse(&bb);
+    if (reuse > 0) reroot(reuse);
+    if (reuse < 0) reset_tree(&bb);
+    tree_pos = bb;
+    result->reused = pool[cur][0].visits;
+
+    int abort_flag = 0;
+    uint64_t total = 0;
+    Worker workers[MCTS_MAX_THREADS];
+    int n_workers = 1;
+    for (int i = 0; i < mcts_threads; i++) {
+        Worker *w = &workers[i];
+        w->rng = (0x9E3779B97F4A7C15ULL * (uint64_t)(i + 1)) ^ (uint64_t)(start * 1e6) ^ bb.key;
+        if (!w->rng) w->rng = 1;
+        w->playouts = 0;
+        w->limits = limits;
+        w->abort_flag = &abort_flag;
+        w->total = &total;
+        if (i > 0) {
+            if (pthread_create(&w->tid, NULL, worker_main, w) != 0) break;
+            n_workers++;
+        }
+    }
+    worker_main(&workers[0]);
+
+    __atomic_store_n(&abort_flag, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < n_workers; i++) {
+        if (i > 0) pthread_join(workers[i].tid, NULL);
+        result->playouts += workers[i].playouts;
+    }
+
+    const MctsNode *nodes = pool[cur];
+    if (nodes[0].state == MCTS_EXPANDED) {
+        for (int i = 0; i < nodes[0].n_children; i++) {
+            const MctsNode *c = &nodes[nodes[0].first_child + i];
+            if (c->visits > result->visits) {
+                result->visits = c->visits;
+                result->best = c->move;
+                result->win_rate = c->wins / (2.0 * c->visits);
+            }
+        }
+    }
+    result->elapsed = search_now() - start;
+    return 1;
+}
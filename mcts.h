@@ -0,0 +1,47 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game.h"
+
+#define MCTS_DEFAULT_MB   64
+#define MCTS_MAX_THREADS  64
+
+/*
+ * 트리 노드 (16B). children 은 pool 안에서 연속 구간 [first_child, first_child + n_children).
+ * wins 는 이 노드로 들어오는 수를 둔 쪽 기준: 승 2, 무 1, 패 0.
+ */
+typedef struct {
+    int32_t first_child;   // -1 이면 미확장
+    int32_t visits;        // virtual loss 포함 (내려갈 때 먼저 +1)
+    int32_t wins;
+    PackedMove move;       // MV_NONE 이면 pass
+    uint8_t n_children;
+    uint8_t state;         // MCTS_LEAF / MCTS_EXPANDING / MCTS_EXPANDED / MCTS_TERMINAL
+} MctsNode;
+
+enum { MCTS_LEAF = 0, MCTS_EXPANDING = 1, MCTS_EXPANDED = 2, MCTS_TERMINAL = 3 };
+
+typedef struct {
+    double deadline;       // search_now() 기준 절대 시각 (초)
+    uint64_t max_playouts; // 0 이면 deadline 까지
+    int *stop;             // 외부 중단 플래그, NULL 이면 deadline 만
+} MctsLimits;
+
+typedef struct {
+    PackedMove best;       // root 에서 방문 수가 가장 많은 수, pass 면 MV_NONE
+    double win_rate;       // best 의 승률 (무승부 0.5)
+    int visits;            // best 의 방문 수
+    uint64_t playouts;     // 이번 호출에서 돌린 playout 수
+    int reused;            // 이전 턴 트리에서 이어받은 root 방문 수
+    double elapsed;
+} MctsResult;
+
+int mcts_init(size_t mb);
+void mcts_free(void);
+void mcts_set_threads(int n);
+int mcts_search(const BitBoard *root, char player,
+                const MctsLimits *limits, MctsResult *result);
+
+#endif
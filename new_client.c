@@ -1,5 +1,5 @@
 #include "../include/client.h"
-#include "../include/game.h"      // directions[8][2] 등 제공
+#include "../include/game.h"      // bitboard 규칙/칸별 마스크 테이블 제공
 #include "../include/json.h"
 #include "../include/board.h"
 #include "../libs/cJSON.h"
@@ -20,7 +20,6 @@
 // -----------------------------------------------------------------------------
 #define INF             1000000000
 #define BOARD_N         BOARD_SIZE   // 8
-#define MAX_MOVES_EST   256          // 안전 여유치
 #define FEATURE_CNT     8
 
 // 단계별(초반/중반/종반) 가중치 테이블
@@ -36,81 +35,50 @@ static inline int phase_index(int empty_cnt) {
     return 2;                         // end‑game
 }
 
-static inline int in_board(int r, int c) {
-    return (unsigned)r < BOARD_N && (unsigned)c < BOARD_N;
-}
-
-// Manhattan 거리  → 중앙화 보너스 (‑distance)
-static inline int central_bonus(int r, int c) {
-    static const int table[BOARD_N][BOARD_N] = {
-        { 7,6,5,4,4,5,6,7 },
-        { 6,5,4,3,3,4,5,6 },
-        { 5,4,3,2,2,3,4,5 },
-        { 4,3,2,1,1,2,3,4 },
-        { 4,3,2,1,1,2,3,4 },
-        { 5,4,3,2,2,3,4,5 },
-        { 6,5,4,3,3,4,5,6 },
-        { 7,6,5,4,4,5,6,7 }
-    };
-    return -table[r][c];
-}
+// Manhattan 거리  → 중앙화 보너스 (‑distance), 칸 번호로 바로 조회
+#define CENTRAL_AT(r, c) (-(((r) < 4 ? 3 - (r) : (r) - 4) + ((c) < 4 ? 3 - (c) : (c) - 4) + 1))
+static const int CENTRAL_BONUS[BOARD_N * BOARD_N] = BB_TABLE64(CENTRAL_AT);
 
 // -----------------------------------------------------------------------------
-//  빠른 mobility / frontier 계산용 LUT  (8‑bit neighborhood mask → frontier?
+//  mobility / frontier 항 (mobility: 한 칸/두 칸 안에 빈칸이 있는 돌 수, 장애물은 상대 쪽으로 집계)
+//  빈칸 인접 fill 하나를 두 항이 같이 쓴다
 // -----------------------------------------------------------------------------
-static unsigned char FRONTIER_LUT[256];
-static void init_frontier_lut(void) {
-    for (int m = 0; m < 256; ++m) {
-        int is_frontier = 0;
-        for (int bit = 0; bit < 8; ++bit) if (!(m & (1 << bit))) { is_frontier = 1; break; }
-        FRONTIER_LUT[m] = (unsigned char)is_frontier;
-    }
+typedef struct {
+    int my_mob;
+    int opp_mob;
+    int interior;     // 빈 이웃이 하나도 없는 내 돌 수
+} EvalTerms;
+
+static inline void eval_terms(uint64_t mine, uint64_t empty, EvalTerms *t) {
+    uint64_t adj_empty = bb_adjacent(empty);
+    uint64_t reach = adj_empty | bb_jump_targets(empty);
+    t->my_mob   = bb_popcount(mine & reach);
+    t->opp_mob  = bb_popcount(~empty & ~mine & reach);
+    t->interior = bb_popcount(mine & ~adj_empty);
 }
 
 // -----------------------------------------------------------------------------
-//  시뮬레이션 적용 (clone / jump) + 특징 추출
+//  시뮬레이션 (clone / jump) + 특징 추출
+//  보드를 바꾸지 않고 root 마스크에서 수 이후의 내 돌/빈칸 마스크만 만들어 계산한다.
+//  수가 바꾸는 칸은 to, flip 된 이웃, (jump 면) from 뿐이므로 복사/undo 가 필요 없다.
 // -----------------------------------------------------------------------------
-static int evaluate_move(char bd[BOARD_N][BOARD_N], int r1, int c1, int r2, int c2,
-                         char me, char opp, int empty_cnt_before)
+static int evaluate_move(const BitBoard *bd, int from, int to, char me, int empty_cnt_before,
+                         EvalTerms *terms)
 {
     int feat[FEATURE_CNT] = {0};
-    int is_jump = (abs(r1 - r2) > 1 || abs(c1 - c2) > 1);
+    int is_jump = (BB_JUMP_MASK[from] & BB_BIT(to)) != 0;
+    int r2 = BB_ROW(to), c2 = BB_COL(to);
 
     // ---- immediate gain & flips ----
-    int flip_cnt = 0;
-    if (is_jump) bd[r1][c1] = '.';
-    bd[r2][c2] = me;
-
-    for (int d = 0; d < 8; ++d) {
-        int nr = r2 + directions[d][0];
-        int nc = c2 + directions[d][1];
-        if (in_board(nr, nc) && bd[nr][nc] == opp) {
-            bd[nr][nc] = me;
-            ++flip_cnt;
-        }
-    }
-    feat[0] = flip_cnt;                         // Immediate gain
+    uint64_t flips = bb_flips(bd, me, to);
+    uint64_t vacated = is_jump ? BB_BIT(from) : 0;
+    uint64_t mine  = (bb_own(bd, me) | BB_BIT(to) | flips) & ~vacated;
+    uint64_t empty = (bb_empty(bd) & ~BB_BIT(to)) | vacated;
+    feat[0] = bb_popcount(flips);               // Immediate gain
 
     // ---- mobility difference after move ----
-    int my_mob = 0, opp_mob = 0;
-    for (int r = 0; r < BOARD_N; ++r) {
-        for (int c = 0; c < BOARD_N; ++c) {
-            if (bd[r][c] == '.') continue;
-            char who = bd[r][c];
-            for (int d = 0; d < 8; ++d) {
-                int nr = r + directions[d][0];
-                int nc = c + directions[d][1];
-                for (int step = 1; step <= 2; ++step, nr += directions[d][0], nc += directions[d][1]) {
-                    if (!in_board(nr, nc)) break;
-                    if (bd[nr][nc] != '.') continue;
-                    if (who == me) ++my_mob; else ++opp_mob;
-                    goto NEXT_CELL;   // 한 칸이라도 비어있으면 mobility 확보
-                }
-            }
-        NEXT_CELL: ;
-        }
-    }
-    feat[1] = my_mob - opp_mob;                 // Mobility Δ
+    eval_terms(mine, empty, terms);
+    feat[1] = terms->my_mob - terms->opp_mob;   // Mobility Δ
 
     // ---- corner & edge ----
     const int corner = ( (r2 == 0 && c2 == 0) || (r2 == 0 && c2 == 7)
@@ -120,28 +88,13 @@ static int evaluate_move(char bd[BOARD_N][BOARD_N], int r1, int c1, int r2, int
     feat[3] = edge;                             // Edge stability
 
     // ---- frontier penalty (after move) ----
-    int frontier_cnt = 0;
-    for (int r = 0; r < BOARD_N; ++r) {
-        for (int c = 0; c < BOARD_N; ++c) if (bd[r][c] == me) {
-            unsigned char mask = 0;
-            int bit = 0;
-            for (int dr = -1; dr <= 1; ++dr) {
-                for (int dc = -1; dc <= 1; ++dc) if (dr || dc) {
-                    int nr = r + dr, nc = c + dc;
-                    if (!in_board(nr, nc) || bd[nr][nc] != '.') mask |= (1 << bit);
-                    ++bit;
-                }
-            }
-            frontier_cnt += FRONTIER_LUT[mask] ^ 1; // 1 if any neighbor empty
-        }
-    }
-    feat[4] = frontier_cnt;
+    feat[4] = terms->interior;
 
     // ---- jump discount ----
     feat[5] = is_jump;
 
     // ---- central bonus ----
-    feat[6] = central_bonus(r2, c2);
+    feat[6] = CENTRAL_BONUS[to];
 
     // ---- parity (빈칸 짝/홀) ----
     int empty_after = empty_cnt_before - 1 - (is_jump ? 0 : 0); // 점프/클론 모두 ‑1
@@ -161,41 +114,24 @@ static int evaluate_move(char bd[BOARD_N][BOARD_N], int r1, int c1, int r2, int
 int generate_move(char board[BOARD_N][BOARD_N], char my_color,
                   int *sr, int *sc, int *dr, int *dc)
 {
-    static int lut_init = 0;
-    if (!lut_init) { init_frontier_lut(); lut_init = 1; }
-
-    char opp = (my_color == 'R' ? 'B' : 'R');
-
-    int empty_cnt = 0;
-    for (int r = 0; r < BOARD_N; ++r)
-        for (int c = 0; c < BOARD_N; ++c)
-            if (board[r][c] == '.') ++empty_cnt;
+    BitBoard root;
+    bb_from_board(&root, board);
+    int empty_cnt = root.n_empty;
 
     int best_score = -INF;
     int best_r1 = -1, best_c1 = -1, best_r2 = -1, best_c2 = -1;
 
     // 1) legal move enumeration + feature scoring
-    typedef struct { int r1,c1,r2,c2,score; } Move;
-    Move moves[MAX_MOVES_EST];
-    int mcnt = 0;
-
-    for (int r = 0; r < BOARD_N; ++r) {
-        for (int c = 0; c < BOARD_N; ++c) if (board[r][c] == my_color) {
-            for (int d = 0; d < 8; ++d) {
-                int nr = r + directions[d][0];
-                int nc = c + directions[d][1];
-                for (int step = 1; step <= 2; ++step, nr += directions[d][0], nc += directions[d][1]) {
-                    if (!in_board(nr, nc)) break;
-                    if (board[nr][nc] != '.') continue;
-
-                    char sim[BOARD_N][BOARD_N];
-                    memcpy(sim, board, sizeof(char)*BOARD_N*BOARD_N);
-                    int sc_score = evaluate_move(sim, r, c, nr, nc, my_color, opp, empty_cnt);
-
-                    moves[mcnt++] = (Move){r,c,nr,nc,sc_score};
-                }
-            }
-        }
+    typedef struct { PackedMove mv; int score; short my_mob, opp_mob; } Move;
+    MoveList list;
+    Move moves[MAX_MOVES];
+    int mcnt = generate_moves(&root, my_color, &list);
+
+    for (int i = 0; i < mcnt; ++i) {
+        EvalTerms t;
+        int sc_score = evaluate_move(&root, MV_FROM(list.moves[i]), MV_TO(list.moves[i]),
+                                     my_color, empty_cnt, &t);
+        moves[i] = (Move){list.moves[i], sc_score, (short)t.my_mob, (short)t.opp_mob};
     }
     if (mcnt == 0) return 0;   // 패스
 
@@ -212,29 +148,22 @@ int generate_move(char board[BOARD_N][BOARD_N], char my_color,
     // 3) 자살 수(상대 mobility 급증+내 급감) 필터 & 최종 선택
     int chosen = 0;
     for (int i = 0; i < limit; ++i) {
-        int r1=moves[i].r1, c1=moves[i].c1, r2=moves[i].r2, c2=moves[i].c2;
-        char sim[BOARD_N][BOARD_N];
-        memcpy(sim, board, sizeof(char)*BOARD_N*BOARD_N);
-        int is_jump = (abs(r1-r2)>1 || abs(c1-c2)>1);
-        evaluate_move(sim, r1, c1, r2, c2, my_color, opp, empty_cnt); // sim 에 반영
-
-        // mobility 재계산
-        int my_m=0, op_m=0;
-        for (int r=0;r<BOARD_N;++r)for(int c=0;c<BOARD_N;++c){
-            if(sim[r][c]=='.')continue;char w=sim[r][c];
-            for(int d=0;d<8;++d){int nr=r+directions[d][0],nc=c+directions[d][1];
-                for(int s=1;s<=2;++s,nr+=directions[d][0],nc+=directions[d][1]){
-                    if(!in_board(nr,nc))break; if(sim[nr][nc]!='.')continue;
-                    if(w==my_color)++my_m; else ++op_m; goto L1;} } L1:; }
+        int from = MV_FROM(moves[i].mv), to = MV_TO(moves[i].mv);
+
+        // 1) 에서 계산해 둔 수 이후 mobility 재사용
+        int my_m = moves[i].my_mob, op_m = moves[i].opp_mob;
         if(op_m-my_m>70 && my_m<5) continue; // 자살 수 컷
 
         best_score = moves[i].score;
-        best_r1=r1;best_c1=c1;best_r2=r2;best_c2=c2;
+        best_r1=BB_ROW(from);best_c1=BB_COL(from);best_r2=BB_ROW(to);best_c2=BB_COL(to);
         chosen=1;
         break;
     }
 
-    if(!chosen){ best_r1=moves[0].r1;best_c1=moves[0].c1;best_r2=moves[0].r2;best_c2=moves[0].c2; }
+    if(!chosen){
+        best_r1=BB_ROW(MV_FROM(moves[0].mv));best_c1=BB_COL(MV_FROM(moves[0].mv));
+        best_r2=BB_ROW(MV_TO(moves[0].mv));  best_c2=BB_COL(MV_TO(moves[0].mv));
+    }
 
     *sr=best_r1; *sc=best_c1; *dr=best_r2; *dc=best_c2;
     return 1;
@@ -264,6 +193,7 @@ static int connect_to_server(const char *ip, const char *port) {
         fprintf(stderr, "Failed to connect to %s:%s\n", ip, port);
         return -1;
     }
+    json_set_nodelay(sockfd);
     return sockfd;
 }
 
@@ -276,15 +206,24 @@ int client_run(const char *ip, const char *port, const char *username) {
         fprintf(stderr, "Failed to connect to %s:%s\n", ip, port);
         return EXIT_FAILURE;
     }
+    JsonReader reader;
+    JsonWriter writer;
+    if (json_reader_init(&reader, JSON_MAX_MSG) < 0) {
+        close(sockfd);
+        return EXIT_FAILURE;
+    }
+    json_writer_init(&writer, JSON_MAX_MSG);
 
     // 1) register 요청
     {
         cJSON *reg = cJSON_CreateObject();
         cJSON_AddStringToObject(reg, "type", "register");
         cJSON_AddStringToObject(reg, "username", username);
-        if (send_json(sockfd, reg) < 0) {
+        if (send_json(&writer, sockfd, reg) < 0) {
             fprintf(stderr, "Failed to send register message\n");
             cJSON_Delete(reg);
+            json_reader_free(&reader);
+            json_writer_free(&writer);
             close(sockfd);
             return EXIT_FAILURE;
         }
@@ -295,7 +234,7 @@ int client_run(const char *ip, const char *port, const char *username) {
     char my_color = 0;
 
     while (1) {
-        cJSON *msg = recv_json(sockfd);
+        cJSON *msg = recv_json(&reader, sockfd);
         if (!msg) {
             break;
         }
@@ -376,7 +315,7 @@ int client_run(const char *ip, const char *port, const char *username) {
                 cJSON_AddNumberToObject(mv, "tx", 0);
                 cJSON_AddNumberToObject(mv, "ty", 0);
             }
-            if (send_json(sockfd, mv) < 0) {
+            if (send_json(&writer, sockfd, mv) < 0) {
                 fprintf(stderr, "Failed to send move/pass message\n");
                 cJSON_Delete(mv);
                 cJSON_Delete(msg);
@@ -447,6 +386,8 @@ int client_run(const char *ip, const char *port, const char *username) {
         cJSON_Delete(msg);
     }
 
+    json_reader_free(&reader);
+    json_writer_free(&writer);
     close(sockfd);
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,357 @@
+#include "../include/nnue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+// 양자화된 weight. SIMD load 를 위해 32 바이트 정렬
+static int16_t w1[NNUE_INPUTS][NNUE_L1] __attribute__((aligned(32)));
+static int16_t b1[NNUE_L1] __attribute__((aligned(32)));
+static int8_t w2[NNUE_L2][2 * NNUE_L1] __attribute__((aligned(32)));
+static int32_t b2[NNUE_L2] __attribute__((aligned(32)));
+static int8_t w3[NNUE_L2] __attribute__((aligned(32)));
+static int32_t b3;
+// 뒤집힘 한 번 = 상대 돌 feature 빼고 내 돌 feature 더하기. 시점 기준 (내 돌 - 상대 돌) 행을 미리 만들어 둔다
+static int16_t flip_rows[64][NNUE_L1] __attribute__((aligned(32)));
+static int loaded = 0;
+
+int nnue_loaded(void) {
+    return loaded;
+}
+
+// color: 0 R, 1 B, 2 장애물 / side: 0 R 시점, 1 B 시점
+int nnue_feature(int sq, int color, int side) {
+    if (color == 2) return 128 + sq;
+    return (color == side ? 0 : 64) + sq;
+}
+
+// -----------------------------------------------------------------------------
+//  SIMD 커널 (AVX2 / SSE4.1 / scalar)
+//  acc_add/acc_sub : accumulator 에 weight 행 하나를 더하고 뺀다 (int16 NNUE_L1 개)
+//  crelu           : 두 시점 accumulator (int16 NNUE_L1 개씩) -> clamp(0, 127) uint8 2 * NNUE_L1 개
+//  propagate       : L2 + clipped ReLU + 출력층, ACT_ONE * W_ONE 단위 int32
+//  L2 합은 >> W_SHIFT 로 활성값 단위로 되돌린다. 음수는 어차피 0 으로 잘리므로
+//  산술 shift 와 나눗셈의 반올림 차이는 결과에 영향이 없다
+// -----------------------------------------------------------------------------
+#if defined(__AVX2__)
+static inline void acc_add(int16_t *acc, const int16_t *row) {
+    for (int i = 0; i < NNUE_L1; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(acc + i));
+        __m256i r = _mm256_load_si256((const __m256i *)(row + i));
+        _mm256_storeu_si256((__m256i *)(acc + i), _mm256_add_epi16(a, r));
+    }
+}
+
+static inline void acc_sub(int16_t *acc, const int16_t *row) {
+    for (int i = 0; i < NNUE_L1; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(acc + i));
+        __m256i r = _mm256_load_si256((const __m256i *)(row + i));
+        _mm256_storeu_si256((__m256i *)(acc + i), _mm256_sub_epi16(a, r));
+    }
+}
+
+static inline void crelu(uint8_t *out, const int16_t *own, const int16_t *opp) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(NNUE_ACT_ONE);
+    for (int i = 0; i < NNUE_L1; i += 16) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(own + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(opp + i));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), one);
+        b = _mm256_min_epi16(_mm256_max_epi16(b, zero), one);
+        // packus 는 128 비트 lane 단위로 섞이므로 64 비트 블록 순서를 되돌리면 아래 절반 own, 위 절반 opp
+        __m256i p = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm_storeu_si128((__m128i *)(out + i), _mm256_castsi256_si128(p));
+        _mm_storeu_si128((__m128i *)(out + NNUE_L1 + i), _mm256_extracti128_si256(p, 1));
+    }
+}
+
+static inline int32_t propagate(const uint8_t *in) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(NNUE_ACT_ONE);
+    __m256i x[2 * NNUE_L1 / 32];
+    for (int i = 0; i < 2 * NNUE_L1 / 32; i++) x[i] = _mm256_load_si256((const __m256i *)in + i);
+
+    __m256i total = _mm256_setzero_si256();
+    for (int o = 0; o < NNUE_L2; o += 8) {
+        __m256i s[8];
+        for (int j = 0; j < 8; j++) {
+            // 127 * 127 * 2 < 32767 이라 maddubs 가 포화되지 않는다
+            s[j] = _mm256_setzero_si256();
+            for (int i = 0; i < 2 * NNUE_L1 / 32; i++) {
+                __m256i w = _mm256_load_si256((const __m256i *)w2[o + j] + i);
+                s[j] = _mm256_add_epi32(s[j], _mm256_madd_epi16(_mm256_maddubs_epi16(x[i], w), ones));
+            }
+        }
+        // 출력 8 개의 부분합을 hadd 로 모아 lane k == 출력 o + k
+        __m256i h0 = _mm256_hadd_epi32(_mm256_hadd_epi32(s[0], s[1]), _mm256_hadd_epi32(s[2], s[3]));
+        __m256i h1 = _mm256_hadd_epi32(_mm256_hadd_epi32(s[4], s[5]), _mm256_hadd_epi32(s[6], s[7]));
+        __m256i sum = _mm256_add_epi32(_mm256_permute2x128_si256(h0, h1, 0x20),
+                                       _mm256_permute2x128_si256(h0, h1, 0x31));
+        sum = _mm256_add_epi32(sum, _mm256_load_si256((const __m256i *)(b2 + o)));
+        sum = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(sum, NNUE_W_SHIFT), zero), one);
+        __m256i w = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)(w3 + o)));
+        total = _mm256_add_epi32(total, _mm256_mullo_epi32(sum, w));
+    }
+    __m128i t = _mm_add_epi32(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+    t = _mm_add_epi32(t, _mm_shuffle_epi32(t, 0x4E));
+    t = _mm_add_epi32(t, _mm_shuffle_epi32(t, 0xB1));
+    return _mm_cvtsi128_si32(t) + b3;
+}
+#elif defined(__SSE4_1__)
+static inline void acc_add(int16_t *acc, const int16_t *row) {
+    for (int i = 0; i < NNUE_L1; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(acc + i));
+        __m128i r = _mm_load_si128((const __m128i *)(row + i));
+        _mm_storeu_si128((__m128i *)(acc + i), _mm_add_epi16(a, r));
+    }
+}
+
+static inline void acc_sub(int16_t *acc, const int16_t *row) {
+    for (int i = 0; i < NNUE_L1; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(acc + i));
+        __m128i r = _mm_load_si128((const __m128i *)(row + i));
+        _mm_storeu_si128((__m128i *)(acc + i), _mm_sub_epi16(a, r));
+    }
+}
+
+static inline void crelu(uint8_t *out, const int16_t *own, const int16_t *opp) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(NNUE_ACT_ONE);
+    for (int i = 0; i < 2 * NNUE_L1; i += 16) {
+        const int16_t *acc = i < NNUE_L1 ? own + i : opp + i - NNUE_L1;
+        __m128i a = _mm_loadu_si128((const __m128i *)acc);
+        __m128i b = _mm_loadu_si128((const __m128i *)(acc + 8));
+        a = _mm_min_epi16(_mm_max_epi16(a, zero), one);
+        b = _mm_min_epi16(_mm_max_epi16(b, zero), one);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packus_epi16(a, b));
+    }
+}
+
+static inline int32_t propagate(const uint8_t *in) {
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(NNUE_ACT_ONE);
+    __m128i x[2 * NNUE_L1 / 16];
+    for (int i = 0; i < 2 * NNUE_L1 / 16; i++) x[i] = _mm_load_si128((const __m128i *)in + i);
+
+    __m128i total = _mm_setzero_si128();
+    for (int o = 0; o < NNUE_L2; o += 4) {
+        __m128i s[4];
+        for (int j = 0; j < 4; j++) {
+            s[j] = _mm_setzero_si128();
+            for (int i = 0; i < 2 * NNUE_L1 / 16; i++) {
+                __m128i w = _mm_load_si128((const __m128i *)w2[o + j] + i);
+                s[j] = _mm_add_epi32(s[j], _mm_madd_epi16(_mm_maddubs_epi16(x[i], w), ones));
+            }
+        }
+        __m128i sum = _mm_hadd_epi32(_mm_hadd_epi32(s[0], s[1]), _mm_hadd_epi32(s[2], s[3]));
+        sum = _mm_add_epi32(sum, _mm_load_si128((const __m128i *)(b2 + o)));
+        sum = _mm_min_epi32(_mm_max_epi32(_mm_srai_epi32(sum, NNUE_W_SHIFT), zero), one);
+        int32_t w4;
+        memcpy(&w4, w3 + o, sizeof(w4));
+        total = _mm_add_epi32(total, _mm_mullo_epi32(sum, _mm_cvtepi8_epi32(_mm_cvtsi32_si128(w4))));
+    }
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0x4E));
+    total = _mm_add_epi32(total, _mm_shuffle_epi32(total, 0xB1));
+    return _mm_cvtsi128_si32(total) + b3;
+}
+#else
+// intrinsic 없는 경로 (-mavx2/-msse4.1 없는 x86, ARM). 고정 길이 loop 를 컴파일러가
+// SSE2 / NEON 으로 vectorize 하도록 쓴다: restrict 로 alias 를 없애고, L2 는 int16 로
+// 넓혀 둔 weight 로 int16 x int16 -> int32 multiply-add 가 되게 한다.
+// gcc 12 미만은 -O2 에서 vectorize 하지 않으므로 이 파일만 켠다
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize("tree-vectorize")
+#endif
+#define NNUE_GENERIC
+static int16_t w2_wide[NNUE_L2][2 * NNUE_L1] __attribute__((aligned(32)));
+
+static inline void acc_add(int16_t *__restrict acc, const int16_t *__restrict row) {
+    for (int i = 0; i < NNUE_L1; i++) acc[i] = (int16_t)(acc[i] + row[i]);
+}
+
+static inline void acc_sub(int16_t *__restrict acc, const int16_t *__restrict row) {
+    for (int i = 0; i < NNUE_L1; i++) acc[i] = (int16_t)(acc[i] - row[i]);
+}
+
+static inline void crelu(uint8_t *__restrict out, const int16_t *own, const int16_t *opp) {
+    for (int i = 0; i < NNUE_L1; i++) {
+        int v = own[i];
+        out[i] = (uint8_t)(v < 0 ? 0 : v > NNUE_ACT_ONE ? NNUE_ACT_ONE : v);
+    }
+    for (int i = 0; i < NNUE_L1; i++) {
+        int v = opp[i];
+        out[NNUE_L1 + i] = (uint8_t)(v < 0 ? 0 : v > NNUE_ACT_ONE ? NNUE_ACT_ONE : v);
+    }
+}
+
+static inline int32_t propagate(const uint8_t *in) {
+    int32_t out = b3;
+    for (int o = 0; o < NNUE_L2; o++) {
+        int32_t v = b2[o];
+        for (int i = 0; i < 2 * NNUE_L1; i++) v += (int16_t)in[i] * w2_wide[o][i];
+        v >>= NNUE_W_SHIFT;
+        if (v < 0) v = 0;
+        if (v > NNUE_ACT_ONE) v = NNUE_ACT_ONE;
+        out += v * w3[o];
+    }
+    return out;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+//  accumulator
+// -----------------------------------------------------------------------------
+void nnue_state_init(NnueState *ns, const BitBoard *bb) {
+    for (int side = 0; side < 2; side++) {
+        int16_t *acc = ns->acc[side];
+        memcpy(acc, b1, sizeof(b1));
+        for (uint64_t m = bb->red; m; m &= m - 1) acc_add(acc, w1[nnue_feature(bb_lsb(m), 0, side)]);
+        for (uint64_t m = bb->blue; m; m &= m - 1) acc_add(acc, w1[nnue_feature(bb_lsb(m), 1, side)]);
+        for (uint64_t m = bb->obstacle; m; m &= m - 1) acc_add(acc, w1[nnue_feature(bb_lsb(m), 2, side)]);
+    }
+}
+
+// 장애물 feature 는 바뀌지 않으므로 돌이 놓이고/빠지고/뒤집힌 칸만 갱신
+void nnue_state_move(NnueState *ns, char player, const MoveUndo *undo) {
+    int color = (player == 'B');
+    for (int side = 0; side < 2; side++) {
+        int16_t *acc = ns->acc[side];
+        acc_add(acc, w1[nnue_feature(undo->to, color, side)]);
+        if (undo->jump) acc_sub(acc, w1[nnue_feature(undo->from, color, side)]);
+        if (color == side) {
+            for (uint64_t m = undo->flips; m; m &= m - 1) acc_add(acc, flip_rows[bb_lsb(m)]);
+        } else {
+            for (uint64_t m = undo->flips; m; m &= m - 1) acc_sub(acc, flip_rows[bb_lsb(m)]);
+        }
+    }
+}
+
+int nnue_eval_state(const NnueState *ns, char me) {
+    int side = (me == 'B');
+    uint8_t in[2 * NNUE_L1] __attribute__((aligned(32)));
+    crelu(in, ns->acc[side], ns->acc[side ^ 1]);
+    return (int)((int64_t)propagate(in) * NNUE_OUT_SCALE / (NNUE_ACT_ONE * NNUE_W_ONE));
+}
+
+int nnue_eval(const BitBoard *bb, char me) {
+    NnueState ns;
+    nnue_state_init(&ns, bb);
+    return nnue_eval_state(&ns, me);
+}
+
+// -----------------------------------------------------------------------------
+//  weight 파일: magic, version, inputs, l1, l2 (uint32) 뒤에
+//  w1 int16, b1 int16, w2 int8, b2 int32, w3 int8, b3 int32 순서
+// -----------------------------------------------------------------------------
+typedef struct {
+    int16_t w1[NNUE_INPUTS][NNUE_L1];
+    int16_t b1[NNUE_L1];
+    int8_t w2[NNUE_L2][2 * NNUE_L1];
+    int32_t b2[NNUE_L2];
+    int8_t w3[NNUE_L2];
+    int32_t b3;
+} NnueQuant;
+
+static int rw_body(FILE *fp, NnueQuant *q, int writing) {
+#define RW(ptr, n) (writing ? fwrite(ptr, sizeof(*(ptr)), n, fp) : fread(ptr, sizeof(*(ptr)), n, fp)) == (size_t)(n)
+    return RW(&q->w1[0][0], NNUE_INPUTS * NNUE_L1) && RW(q->b1, NNUE_L1) &&
+           RW(&q->w2[0][0], NNUE_L2 * 2 * NNUE_L1) && RW(q->b2, NNUE_L2) &&
+           RW(q->w3, NNUE_L2) && RW(&q->b3, 1);
+#undef RW
+}
+
+int nnue_load(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror("open nnue");
+        return -1;
+    }
+    char magic[8];
+    uint32_t version, dims[3];
+    int ok = fread(magic, sizeof(magic), 1, fp) == 1 &&
+             fread(&version, sizeof(version), 1, fp) == 1 &&
+             fread(dims, sizeof(dims), 1, fp) == 1 &&
+             memcmp(magic, NNUE_MAGIC, sizeof(NNUE_MAGIC)) == 0 &&
+             version == NNUE_VERSION && dims[0] == NNUE_INPUTS &&
+             dims[1] == NNUE_L1 && dims[2] == NNUE_L2;
+    // 읽는 도중 실패해도 기존 weight 가 반쯤 덮이지 않게 임시 버퍼로
+    NnueQuant *q = ok ? (NnueQuant *)malloc(sizeof(NnueQuant)) : NULL;
+    if (q && rw_body(fp, q, 0)) {
+        memcpy(w1, q->w1, sizeof(w1));
+        memcpy(b1, q->b1, sizeof(b1));
+        memcpy(w2, q->w2, sizeof(w2));
+        memcpy(b2, q->b2, sizeof(b2));
+        memcpy(w3, q->w3, sizeof(w3));
+        b3 = q->b3;
+        for (int sq = 0; sq < 64; sq++)
+            for (int i = 0; i < NNUE_L1; i++)
+                flip_rows[sq][i] = (int16_t)(w1[sq][i] - w1[64 + sq][i]);
+#ifdef NNUE_GENERIC
+        for (int o = 0; o < NNUE_L2; o++)
+            for (int i = 0; i < 2 * NNUE_L1; i++) w2_wide[o][i] = w2[o][i];
+#endif
+        loaded = 1;
+    } else {
+        fprintf(stderr, "Invalid nnue file: %s\n", path);
+        ok = 0;
+    }
+    free(q);
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+static int quantize(float v, float scale, int lim) {
+    long r = lrintf(v * scale);
+    if (r > lim) r = lim;
+    if (r < -lim) r = -lim;
+    return (int)r;
+}
+
+int nnue_save(const char *path, const NnueFloat *net) {
+    NnueQuant *q = (NnueQuant *)calloc(1, sizeof(NnueQuant));
+    if (!q) {
+        perror("calloc");
+        return -1;
+    }
+    for (int f = 0; f < NNUE_INPUTS; f++)
+        for (int i = 0; i < NNUE_L1; i++)
+            q->w1[f][i] = (int16_t)quantize(net->w1[f][i], NNUE_ACT_ONE, 32767);
+    for (int i = 0; i < NNUE_L1; i++)
+        q->b1[i] = (int16_t)quantize(net->b1[i], NNUE_ACT_ONE, 32767);
+    for (int o = 0; o < NNUE_L2; o++) {
+        for (int i = 0; i < 2 * NNUE_L1; i++)
+            q->w2[o][i] = (int8_t)quantize(net->w2[o][i], NNUE_W_ONE, 127);
+        q->b2[o] = quantize(net->b2[o], NNUE_ACT_ONE * NNUE_W_ONE, 1 << 30);
+        q->w3[o] = (int8_t)quantize(net->w3[o], NNUE_W_ONE, 127);
+    }
+    q->b3 = quantize(net->b3, NNUE_ACT_ONE * NNUE_W_ONE, 1 << 30);
+
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        perror("fopen nnue");
+        free(q);
+        return -1;
+    }
+    char magic[8] = { 0 };
+    memcpy(magic, NNUE_MAGIC, sizeof(NNUE_MAGIC));
+    uint32_t version = NNUE_VERSION, dims[3] = { NNUE_INPUTS, NNUE_L1, NNUE_L2 };
+    int ok = fwrite(magic, sizeof(magic), 1, fp) == 1 &&
+             fwrite(&version, sizeof(version), 1, fp) == 1 &&
+             fwrite(dims, sizeof(dims), 1, fp) == 1 &&
+             rw_body(fp, q, 1);
+    if (fclose(fp) != 0) ok = 0;
+    free(q);
+    if (!ok) {
+        fprintf(stderr, "Failed to write nnue: %s\n", path);
+        return -1;
+    }
+    return 0;
+}
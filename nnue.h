@@ -0,0 +1,54 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <stdint.h>
+#include "game.h"
+
+#define NNUE_MAGIC     "OFNNUE1"
+#define NNUE_VERSION   1
+#define NNUE_INPUTS    192     // 64 칸 x {내 돌, 상대 돌, 장애물}
+#define NNUE_L1        16      // 시점 하나의 accumulator 크기
+#define NNUE_L2        8
+
+// 양자화 scale: 활성값 127 == 1.0, int8 weight 64 == 1.0
+// SIMD 경로는 NNUE_L1 이 16 의 배수, NNUE_L2 가 8 의 배수라고 가정한다
+#define NNUE_ACT_ONE   127
+#define NNUE_W_SHIFT   6
+#define NNUE_W_ONE     (1 << NNUE_W_SHIFT)
+#define NNUE_OUT_SCALE 256     // 출력 1.0 == 평가 256 (돌 16 개)
+
+/*
+ * 작은 NNUE 구조의 평가 함수.
+ *   입력    : 시점별 192 개 sparse feature (돌/장애물이 있는 칸만 켜짐)
+ *   L1      : int16 weight 192 x 16, 시점 2 개 accumulator 를 둘 차례 먼저 이어 붙임
+ *   L2      : clipped ReLU(0..127) 32 개 -> int8 weight 8 개 출력
+ *   출력    : clipped ReLU 8 개 -> int8 weight 1 개
+ * accumulator 는 수를 둘 때 바뀐 칸의 weight 행만 더하고 빼서 갱신한다.
+ * 층 크기는 SIMD 없는 빌드 (ARM, -mavx2 없는 x86) 에서도 EVAL_SIMPLE 과 같은 탐색 depth 가
+ * 나오도록 작게 잡았다 (node 속도: -O2 generic 경로 ~90%, AVX2 ~95%).
+ * 점수 단위는 search.c evaluate 와 같다 (돌 하나 = 16).
+ */
+typedef struct {
+    int16_t acc[2][NNUE_L1];     // [0] R 시점, [1] B 시점
+} NnueState;
+
+// float 로 학습한 weight (nnuetrain 이 양자화해서 저장)
+typedef struct {
+    float w1[NNUE_INPUTS][NNUE_L1];
+    float b1[NNUE_L1];
+    float w2[NNUE_L2][2 * NNUE_L1];
+    float b2[NNUE_L2];
+    float w3[NNUE_L2];
+    float b3;
+} NnueFloat;
+
+int nnue_load(const char *path);
+int nnue_save(const char *path, const NnueFloat *net);
+int nnue_loaded(void);
+int nnue_feature(int sq, int color, int side);
+void nnue_state_init(NnueState *ns, const BitBoard *bb);
+void nnue_state_move(NnueState *ns, char player, const MoveUndo *undo);
+int nnue_eval_state(const NnueState *ns, char me);
+int nnue_eval(const BitBoard *bb, char me);
+
+#endif
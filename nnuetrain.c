@@ -0,0 +1,172 @@
+/*
+g++ -O2 -Iinclude src/nnuetrain.c src/tunedata.c src/nnue.c src/pattern.c src/search.c src/tt.c src/game.c -lpthread -o nnuetrain
+./nnuetrain -n 30000 -d 1 -e 10 -o weights.nnue      # 30000 게임 생성, 10 epoch 학습
+./nnuetrain -n 30000 -d 2 --play weights.nnue -o weights2.nnue   # 기존 network 로 두면서 데이터 생성
+*/
+
+#include "../include/nnue.h"
+#include "../include/search.h"
+#include "../include/tt.h"
+#include "../include/tunedata.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define W_LIMIT    (127.0f / NNUE_W_ONE)   // int8 로 양자화되는 weight 의 범위
+
+static TuneSet data;
+static NnueFloat net;
+
+static inline float rand_uniform(uint64_t *s, float range) {
+    return ((float)(next_rand(s) >> 40) / (float)(1 << 24) * 2.0f - 1.0f) * range;
+}
+
+static inline float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : v > hi ? hi : v;
+}
+
+static void init_net(uint64_t *rng) {
+    for (int f = 0; f < NNUE_INPUTS; f++)
+        for (int i = 0; i < NNUE_L1; i++) net.w1[f][i] = rand_uniform(rng, 0.1f);
+    for (int i = 0; i < NNUE_L1; i++) net.b1[i] = 0.5f;
+    for (int o = 0; o < NNUE_L2; o++) {
+        for (int i = 0; i < 2 * NNUE_L1; i++) net.w2[o][i] = rand_uniform(rng, 0.15f);
+        net.b2[o] = 0.5f;
+        net.w3[o] = rand_uniform(rng, 0.5f);
+    }
+    net.b3 = 0.0f;
+}
+
+// 둘 차례 시점 feature 와 상대 시점 feature 목록, 반환값은 개수 (두 시점 같은 개수)
+static int features(const BitBoard *bb, char me, int *own_view, int *opp_view) {
+    int side = (me == 'B'), k = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        int color = (bb->red >> sq) & 1 ? 0 : (bb->blue >> sq) & 1 ? 1 : (bb->obstacle >> sq) & 1 ? 2 : -1;
+        if (color < 0) continue;
+        own_view[k] = nnue_feature(sq, color, side);
+        opp_view[k] = nnue_feature(sq, color, side ^ 1);
+        k++;
+    }
+    return k;
+}
+
+// float network 로 SGD 한 번. 반환값은 제곱 오차
+static float train_step(const TuneSample *s, float lr) {
+    int fo[64], fp[64];
+    int k = features(&s->bb, bb_side(&s->bb), fo, fp);
+
+    float acc[2 * NNUE_L1], a1[2 * NNUE_L1];
+    for (int i = 0; i < NNUE_L1; i++) acc[i] = acc[NNUE_L1 + i] = net.b1[i];
+    for (int n = 0; n < k; n++) {
+        for (int i = 0; i < NNUE_L1; i++) {
+            acc[i] += net.w1[fo[n]][i];
+            acc[NNUE_L1 + i] += net.w1[fp[n]][i];
+        }
+    }
+    for (int j = 0; j < 2 * NNUE_L1; j++) a1[j] = clampf(acc[j], 0.0f, 1.0f);
+
+    float z2[NNUE_L2], a2[NNUE_L2], y = net.b3;
+    for (int o = 0; o < NNUE_L2; o++) {
+        float z = net.b2[o];
+        for (int j = 0; j < 2 * NNUE_L1; j++) z += net.w2[o][j] * a1[j];
+        z2[o] = z;
+        a2[o] = clampf(z, 0.0f, 1.0f);
+        y += net.w3[o] * a2[o];
+    }
+
+    float err = y - (float)s->target / NNUE_OUT_SCALE;
+    float d1[2 * NNUE_L1] = { 0 };
+    for (int o = 0; o < NNUE_L2; o++) {
+        float d2 = (z2[o] > 0.0f && z2[o] < 1.0f) ? err * net.w3[o] : 0.0f;
+        net.w3[o] = clampf(net.w3[o] - lr * err * a2[o], -W_LIMIT, W_LIMIT);
+        if (d2 == 0.0f) continue;
+        for (int j = 0; j < 2 * NNUE_L1; j++) {
+            d1[j] += d2 * net.w2[o][j];
+            net.w2[o][j] = clampf(net.w2[o][j] - lr * d2 * a1[j], -W_LIMIT, W_LIMIT);
+        }
+        net.b2[o] -= lr * d2;
+    }
+    net.b3 -= lr * err;
+
+    for (int j = 0; j < 2 * NNUE_L1; j++)
+        if (acc[j] <= 0.0f || acc[j] >= 1.0f) d1[j] = 0.0f;
+    for (int i = 0; i < NNUE_L1; i++) net.b1[i] -= lr * (d1[i] + d1[NNUE_L1 + i]);
+    for (int n = 0; n < k; n++) {
+        for (int i = 0; i < NNUE_L1; i++) {
+            net.w1[fo[n]][i] -= lr * d1[i];
+            net.w1[fp[n]][i] -= lr * d1[NNUE_L1 + i];
+        }
+    }
+    return err * err;
+}
+
+int main(int argc, char *argv[]) {
+    int n_games = 1000, depth = 2, epochs = 10, random_plies = 8, epsilon = 10, horizon = 1;
+    double lr = 0.01;
+    uint64_t seed = 1;
+    const char *play = NULL, *out = "weights.nnue";
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            n_games = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            depth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+            epochs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            random_plies = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--epsilon") == 0 && i + 1 < argc)
+            epsilon = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc)
+            horizon = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--lr") == 0 && i + 1 < argc)
+            lr = atof(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--play") == 0 && i + 1 < argc)
+            play = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out = argv[++i];
+        else {
+            printf("Usage: %s [-n games] [-d depth] [-e epochs] [-r random plies] [--epsilon %%]\n"
+                   "          [-H horizon plies] [--lr rate] [-s seed] [--play nnue] [-o nnue]\n",
+                   argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (tt_init(16, 0) < 0) return EXIT_FAILURE;
+    // 양자화된 파일에서는 float weight 를 되살릴 수 없으므로 --play 는 데이터 생성에만 쓴다
+    if (play && (nnue_load(play) < 0 || search_set_eval(EVAL_NNUE) < 0)) return EXIT_FAILURE;
+
+    uint64_t rng = seed * 0x9E3779B97F4A7C15ULL;
+    if (!rng) rng = 1;
+    double t0 = search_now();
+    for (int g = 0; g < n_games; g++) {
+        tune_play_game(&data, &rng, depth, random_plies, epsilon, horizon);
+        if ((g + 1) % 100 == 0) {
+            fprintf(stderr, "\r%d/%d games, %zu positions", g + 1, n_games, data.count);
+        }
+    }
+    fprintf(stderr, "\n");
+
+    init_net(&rng);
+    for (int e = 0; e < epochs; e++) {
+        double sq_err = 0.0;
+        for (size_t n = 0; n < data.count; n++) {
+            // 게임 순서대로 돌면 한 게임 국면들이 몰리므로 섞어서 방문
+            sq_err += train_step(&data.samples[next_rand(&rng) % data.count], (float)lr);
+        }
+        double rmse = sqrt(sq_err / data.count) * NNUE_OUT_SCALE;
+        fprintf(stderr, "epoch %d: rmse %.1f (%.2f discs)\n", e + 1, rmse, rmse / 16.0);
+    }
+
+    if (nnue_save(out, &net) < 0) return EXIT_FAILURE;
+    printf("%zu positions from %d games, wrote %s (%.1f s)\n", data.count, n_games, out,
+           search_now() - t0);
+
+    tune_set_free(&data);
+    tt_free();
+    return EXIT_SUCCESS;
+}
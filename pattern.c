@@ -0,0 +1,298 @@
+#include "../include/pattern.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_CELLS  10
+
+enum {
+    PT_LINE0, PT_LINE1, PT_LINE2, PT_LINE3,          // 가장자리에서 0..3 번째 가로/세로 줄
+    PT_DIAG4, PT_DIAG5, PT_DIAG6, PT_DIAG7, PT_DIAG8,
+    PT_CORNER33,
+    PT_EDGE2X,                                       // 가장자리 8 칸 + X 칸 2 개
+    PT_TYPES
+};
+
+typedef struct {
+    int type;
+    int len;
+    uint8_t cells[MAX_CELLS];   // index 의 3^0 자리부터
+    uint64_t mask;
+} PatternInstance;
+
+static PatternInstance instances[PATTERN_INSTANCES];
+static int n_instances = 0;
+
+// 칸 -> 그 칸을 포함하는 instance 와 그 칸의 자릿값 (증분 갱신용)
+#define MAX_SQ_INSTANCES 8
+typedef struct {
+    int count;
+    uint8_t inst[MAX_SQ_INSTANCES];
+    uint16_t pow3[MAX_SQ_INSTANCES];
+} SquareRef;
+static SquareRef sq_refs[64];
+static int type_offset[PT_TYPES + 1];
+static int16_t *weights = NULL;        // [PATTERN_PHASES][table_size]
+static int table_size = 0;
+
+static const int POW3[MAX_CELLS + 1] = { 1, 3, 9, 27, 81, 243, 729, 2187, 6561, 19683, 59049 };
+
+// 8 가지 대칭 (회전 4 x 뒤집기 2)
+static int transform(int sq, int t) {
+    int r = BB_ROW(sq), c = BB_COL(sq), tmp;
+    if (t & 4) { tmp = r; r = c; c = tmp; }
+    if (t & 1) r = 7 - r;
+    if (t & 2) c = 7 - c;
+    return BB_SQ(r, c);
+}
+
+// base 칸 배치를 대칭으로 돌려 서로 다른 칸 집합만 instance 로 등록
+static void add_type(int type, const int *cells, int len) {
+    for (int t = 0; t < 8; t++) {
+        PatternInstance p;
+        p.type = type;
+        p.len = len;
+        p.mask = 0;
+        for (int k = 0; k < len; k++) {
+            p.cells[k] = (uint8_t)transform(cells[k], t);
+            p.mask |= BB_BIT(p.cells[k]);
+        }
+        int dup = 0;
+        for (int i = 0; i < n_instances; i++)
+            if (instances[i].mask == p.mask) { dup = 1; break; }
+        if (!dup) instances[n_instances++] = p;
+    }
+}
+
+/*
+ * 기본 weight: 돌 하나 16 + 잘 안 뒤집히는 칸(코너/가장자리) 가산.
+ * 한 칸이 여러 패턴에 들어가므로 칸 값을 그 칸이 속한 패턴 수로 나눠 나눠 담는다.
+ * 종반 phase 0 은 돌 수만.
+ */
+static void default_weights(void) {
+    int cover[64] = { 0 };
+    for (int i = 0; i < n_instances; i++)
+        for (int k = 0; k < instances[i].len; k++) cover[instances[i].cells[k]]++;
+
+    for (int phase = 0; phase < PATTERN_PHASES; phase++) {
+        int16_t *w = weights + (size_t)phase * table_size;
+        for (int type = 0; type < PT_TYPES; type++) {
+            // type 의 첫 instance 를 대표로 (대칭이라 칸 값/cover 는 모두 같다)
+            const PatternInstance *p = NULL;
+            for (int i = 0; i < n_instances && !p; i++)
+                if (instances[i].type == type) p = &instances[i];
+            float cell[MAX_CELLS];
+            for (int k = 0; k < p->len; k++) {
+                int sq = p->cells[k], r = BB_ROW(sq), c = BB_COL(sq);
+                int edge = (r == 0 || r == 7) + (c == 0 || c == 7);
+                float v = 16.0f + (phase ? 3.0f * edge : 0.0f);
+                cell[k] = v / cover[sq];
+            }
+            for (int idx = 0; idx < POW3[p->len]; idx++) {
+                float s = 0.0f;
+                for (int k = 0, x = idx; k < p->len; k++, x /= 3) {
+                    if (x % 3 == 1) s += cell[k];
+                    else if (x % 3 == 2) s -= cell[k];
+                }
+                w[type_offset[type] + idx] = (int16_t)(s >= 0 ? s + 0.5f : s - 0.5f);
+            }
+        }
+    }
+}
+
+int pattern_init(void) {
+    if (weights) return 0;
+    n_instances = 0;
+
+    for (int d = 0; d < 4; d++) {
+        int cells[8];
+        for (int c = 0; c < 8; c++) cells[c] = BB_SQ(d, c);
+        add_type(PT_LINE0 + d, cells, 8);
+    }
+    for (int len = 4; len <= 8; len++) {
+        int cells[8];
+        for (int i = 0; i < len; i++) cells[i] = BB_SQ(i, len - 1 - i);
+        add_type(PT_DIAG4 + len - 4, cells, len);
+    }
+    {
+        int cells[9];
+        for (int i = 0; i < 9; i++) cells[i] = BB_SQ(i / 3, i % 3);
+        add_type(PT_CORNER33, cells, 9);
+    }
+    {
+        int cells[10];
+        for (int c = 0; c < 8; c++) cells[c] = BB_SQ(0, c);
+        cells[8] = BB_SQ(1, 1);
+        cells[9] = BB_SQ(1, 6);
+        add_type(PT_EDGE2X, cells, 10);
+    }
+
+    static const int type_len[PT_TYPES] = { 8, 8, 8, 8, 4, 5, 6, 7, 8, 9, 10 };
+    table_size = 0;
+    for (int t = 0; t < PT_TYPES; t++) {
+        type_offset[t] = table_size;
+        table_size += POW3[type_len[t]];
+    }
+    type_offset[PT_TYPES] = table_size;
+
+    memset(sq_refs, 0, sizeof(sq_refs));
+    for (int i = 0; i < n_instances; i++) {
+        for (int k = 0; k < instances[i].len; k++) {
+            SquareRef *r = &sq_refs[instances[i].cells[k]];
+            r->inst[r->count] = (uint8_t)i;
+            r->pow3[r->count] = (uint16_t)POW3[k];
+            r->count++;
+        }
+    }
+
+    weights = (int16_t *)malloc((size_t)PATTERN_PHASES * table_size * sizeof(int16_t));
+    if (!weights) {
+        perror("malloc");
+        return -1;
+    }
+    default_weights();
+    return 0;
+}
+
+int pattern_phase(const BitBoard *bb) {
+    int phase = bb->n_empty >> 4;
+    return phase < PATTERN_PHASES ? phase : PATTERN_PHASES - 1;
+}
+
+int pattern_features(const BitBoard *bb, char me, int *offsets) {
+    uint64_t own = bb_own(bb, me), opp = bb_opp(bb, me);
+    int n = 0;
+    for (int i = 0; i < n_instances; i++) {
+        const PatternInstance *p = &instances[i];
+        if (p->mask & bb->obstacle) continue;
+        int idx = 0;
+        for (int k = p->len - 1; k >= 0; k--) {
+            int sq = p->cells[k];
+            idx = idx * 3 + (int)((own >> sq) & 1) + 2 * (int)((opp >> sq) & 1);
+        }
+        offsets[n++] = type_offset[p->type] + idx;
+    }
+    return n;
+}
+
+// 42 번의 테이블 lookup
+int pattern_eval(const BitBoard *bb, char me) {
+    int offsets[PATTERN_INSTANCES];
+    int n = pattern_features(bb, me, offsets);
+    const int16_t *w = weights + (size_t)pattern_phase(bb) * table_size;
+    int score = 0;
+    for (int i = 0; i < n; i++) score += w[offsets[i]];
+    return score;
+}
+
+void pattern_state_init(PatternState *ps, const BitBoard *bb) {
+    memset(ps, 0, sizeof(*ps));
+    for (int i = 0; i < n_instances; i++)
+        if (instances[i].mask & bb->obstacle) ps->skip |= 1ULL << i;
+    for (uint64_t m = bb->red; m; m &= m - 1) {
+        const SquareRef *r = &sq_refs[bb_lsb(m)];
+        for (int j = 0; j < r->count; j++) {
+            ps->idx[0][r->inst[j]] += r->pow3[j];
+            ps->idx[1][r->inst[j]] += 2 * r->pow3[j];
+        }
+    }
+    for (uint64_t m = bb->blue; m; m &= m - 1) {
+        const SquareRef *r = &sq_refs[bb_lsb(m)];
+        for (int j = 0; j < r->count; j++) {
+            ps->idx[0][r->inst[j]] += 2 * r->pow3[j];
+            ps->idx[1][r->inst[j]] += r->pow3[j];
+        }
+    }
+}
+
+// 칸 하나의 자릿수 변화: own 시점 d_own, 상대 시점 d_opp (자릿값 배수)
+static inline void apply_square(PatternState *ps, int sq, int side, int d_own, int d_opp) {
+    const SquareRef *r = &sq_refs[sq];
+    for (int j = 0; j < r->count; j++) {
+        ps->idx[side][r->inst[j]]     += (uint16_t)(d_own * r->pow3[j]);
+        ps->idx[side ^ 1][r->inst[j]] += (uint16_t)(d_opp * r->pow3[j]);
+    }
+}
+
+// make_move 가 남긴 undo 로 갱신. 자릿수는 내 시점 (0 빈칸, 1 나, 2 상대) / 상대 시점 (0, 2, 1):
+// 빈칸->내 돌 +1/+2, 상대 돌->내 돌 -1/+1, jump 출발지 비움 -1/-2
+void pattern_state_move(PatternState *ps, char player, const MoveUndo *undo) {
+    int side = (player == 'B');
+    apply_square(ps, undo->to, side, 1, 2);
+    if (undo->jump) apply_square(ps, undo->from, side, -1, -2);
+    for (uint64_t m = undo->flips; m; m &= m - 1)
+        apply_square(ps, bb_lsb(m), side, -1, 1);
+}
+
+int pattern_eval_state(const PatternState *ps, const BitBoard *bb, char me) {
+    const uint16_t *idx = ps->idx[me == 'B'];
+    const int16_t *w = weights + (size_t)pattern_phase(bb) * table_size;
+    int score = 0;
+    for (int i = 0; i < n_instances; i++) {
+        if ((ps->skip >> i) & 1) continue;
+        score += w[type_offset[instances[i].type] + idx[i]];
+    }
+    return score;
+}
+
+int pattern_table_size(void) {
+    return table_size;
+}
+
+int16_t *pattern_weights(int phase) {
+    return weights + (size_t)phase * table_size;
+}
+
+int pattern_load(const char *path) {
+    if (pattern_init() < 0) return -1;
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror("open patterns");
+        return -1;
+    }
+    char magic[8];
+    uint32_t version, phases, size;
+    int ok = fread(magic, sizeof(magic), 1, fp) == 1 &&
+             fread(&version, sizeof(version), 1, fp) == 1 &&
+             fread(&phases, sizeof(phases), 1, fp) == 1 &&
+             fread(&size, sizeof(size), 1, fp) == 1 &&
+             memcmp(magic, PATTERN_MAGIC, sizeof(PATTERN_MAGIC)) == 0 &&
+             version == PATTERN_VERSION && phases == PATTERN_PHASES &&
+             size == (uint32_t)table_size;
+    // 읽는 도중 실패해도 기존 weight 가 반쯤 덮이지 않게 임시 버퍼로
+    size_t total = (size_t)PATTERN_PHASES * table_size;
+    int16_t *buf = ok ? (int16_t *)malloc(total * sizeof(int16_t)) : NULL;
+    if (buf && fread(buf, sizeof(int16_t), total, fp) == total) {
+        memcpy(weights, buf, total * sizeof(int16_t));
+    } else {
+        fprintf(stderr, "Invalid pattern file: %s\n", path);
+        ok = 0;
+    }
+    free(buf);
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+int pattern_save(const char *path) {
+    if (pattern_init() < 0) return -1;
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        perror("fopen patterns");
+        return -1;
+    }
+    char magic[8] = { 0 };
+    memcpy(magic, PATTERN_MAGIC, sizeof(PATTERN_MAGIC));
+    uint32_t version = PATTERN_VERSION, phases = PATTERN_PHASES, size = (uint32_t)table_size;
+    size_t total = (size_t)PATTERN_PHASES * table_size;
+    int ok = fwrite(magic, sizeof(magic), 1, fp) == 1 &&
+             fwrite(&version, sizeof(version), 1, fp) == 1 &&
+             fwrite(&phases, sizeof(phases), 1, fp) == 1 &&
+             fwrite(&size, sizeof(size), 1, fp) == 1 &&
+             fwrite(weights, sizeof(int16_t), total, fp) == total;
+    if (fclose(fp) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "Failed to write patterns: %s\n", path);
+        return -1;
+    }
+    return 0;
+}
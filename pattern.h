@@ -0,0 +1,40 @@
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include <stdint.h>
+#include "game.h"
+
+#define PATTERN_MAGIC      "OFPAT1"
+#define PATTERN_VERSION    1
+#define PATTERN_PHASES     4       // 빈칸 수 16 개 단위: 0-15, 16-31, 32-47, 48-
+#define PATTERN_INSTANCES  42      // 가로/세로 16 + 대각선 18 + 코너 3x3 4 + edge-2x 4
+
+/*
+ * 각 칸 상태를 0 빈칸 / 1 내 돌 / 2 상대 돌 로 보고 패턴 칸들을 3진수 index 로 만든다.
+ * 대칭인 패턴끼리는 같은 weight 테이블을 쓴다 (type 별 3^len 개 int16).
+ * 장애물이 낀 패턴은 건너뛴다 (그 칸은 절대 바뀌지 않으므로 모양 자체가 다른 패턴).
+ * 점수 단위는 search.c evaluate 와 같다 (돌 하나 = 16).
+ *
+ * 탐색용 증분 상태: R 시점(idx[0])과 B 시점(idx[1]) index 를 둘 다 들고 있어서
+ * 수를 둘 때 바뀐 칸(to, jump 의 from, 뒤집힌 돌)만 더하고 빼면 된다.
+ */
+typedef struct {
+    uint16_t idx[2][PATTERN_INSTANCES];
+    uint64_t skip;       // 장애물이 낀 instance (bit i)
+} PatternState;
+
+int pattern_init(void);
+int pattern_load(const char *path);
+int pattern_save(const char *path);
+int pattern_phase(const BitBoard *bb);
+int pattern_eval(const BitBoard *bb, char me);
+void pattern_state_init(PatternState *ps, const BitBoard *bb);
+void pattern_state_move(PatternState *ps, char player, const MoveUndo *undo);
+int pattern_eval_state(const PatternState *ps, const BitBoard *bb, char me);
+
+// 튜너용: 현재 국면에서 켜진 weight 위치 (phase 테이블 안의 offset), 반환값은 개수
+int pattern_features(const BitBoard *bb, char me, int *offsets);
+int pattern_table_size(void);
+int16_t *pattern_weights(int phase);
+
+#endif
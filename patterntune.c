@@ -0,0 +1,115 @@
+/*
+g++ -O2 -Iinclude src/patterntune.c src/tunedata.c src/pattern.c src/nnue.c src/search.c src/tt.c src/game.c -lpthread -o patterntune
+./patterntune -n 30000 -d 1 -e 6 --lr 0.2 -o weights.pat   # 30000 게임 생성, 6 epoch 학습
+./patterntune -n 30000 -i weights.pat -o weights2.pat       # 기존 weight 로 두면서 이어서
+*/
+
+#include "../include/pattern.h"
+#include "../include/search.h"
+#include "../include/tt.h"
+#include "../include/tunedata.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static TuneSet data;
+
+int main(int argc, char *argv[]) {
+    int n_games = 1000, depth = 2, epochs = 8, random_plies = 8, epsilon = 10, horizon = 1;
+    double lr = 0.2;
+    uint64_t seed = 1;
+    const char *in = NULL, *out = "weights.pat";
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            n_games = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            depth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+            epochs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            random_plies = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--epsilon") == 0 && i + 1 < argc)
+            epsilon = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc)
+            horizon = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--lr") == 0 && i + 1 < argc)
+            lr = atof(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            in = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out = argv[++i];
+        else {
+            printf("Usage: %s [-n games] [-d depth] [-e epochs] [-r random plies] [--epsilon %%]\n"
+                   "          [-H horizon plies] [--lr rate] [-s seed] [-i weights] [-o weights]\n",
+                   argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (pattern_init() < 0 || tt_init(16, 0) < 0) return EXIT_FAILURE;
+    if (in && pattern_load(in) < 0) return EXIT_FAILURE;
+    // 자기 자신의 weight 로 두면 학습 데이터가 점점 나아진다
+    search_set_eval(in ? EVAL_PATTERN : EVAL_SIMPLE);
+
+    uint64_t rng = seed * 0x9E3779B97F4A7C15ULL;
+    if (!rng) rng = 1;
+    double t0 = search_now();
+    for (int g = 0; g < n_games; g++) {
+        tune_play_game(&data, &rng, depth, random_plies, epsilon, horizon);
+        if ((g + 1) % 100 == 0) {
+            fprintf(stderr, "\r%d/%d games, %zu positions", g + 1, n_games, data.count);
+        }
+    }
+    fprintf(stderr, "\n");
+
+    // int16 weight 를 float 로 옮겨 SGD, 끝나면 반올림해서 되돌린다
+    int size = pattern_table_size();
+    float *w = (float *)malloc((size_t)PATTERN_PHASES * size * sizeof(float));
+    if (!w) { perror("malloc"); return EXIT_FAILURE; }
+    for (int ph = 0; ph < PATTERN_PHASES; ph++) {
+        const int16_t *src = pattern_weights(ph);
+        for (int i = 0; i < size; i++) w[(size_t)ph * size + i] = src[i];
+    }
+
+    for (int e = 0; e < epochs; e++) {
+        double sq_err = 0.0;
+        for (size_t n = 0; n < data.count; n++) {
+            // 게임 순서대로 돌면 한 게임 국면들이 몰리므로 섞어서 방문
+            const TuneSample *s = &data.samples[next_rand(&rng) % data.count];
+            int offsets[PATTERN_INSTANCES];
+            int k = pattern_features(&s->bb, bb_side(&s->bb), offsets);
+            if (k == 0) continue;
+            float *wp = w + (size_t)pattern_phase(&s->bb) * size;
+            float pred = 0.0f;
+            for (int i = 0; i < k; i++) pred += wp[offsets[i]];
+            float err = (float)s->target - pred;
+            sq_err += (double)err * err;
+            float step = (float)lr * err / k;
+            for (int i = 0; i < k; i++) wp[offsets[i]] += step;
+        }
+        fprintf(stderr, "epoch %d: rmse %.1f (%.2f discs)\n", e + 1,
+                sqrt(sq_err / data.count), sqrt(sq_err / data.count) / 16.0);
+    }
+
+    for (int ph = 0; ph < PATTERN_PHASES; ph++) {
+        int16_t *dst = pattern_weights(ph);
+        for (int i = 0; i < size; i++) {
+            float v = w[(size_t)ph * size + i];
+            if (v > 32767.0f) v = 32767.0f;
+            if (v < -32767.0f) v = -32767.0f;
+            dst[i] = (int16_t)lrintf(v);
+        }
+    }
+    if (pattern_save(out) < 0) return EXIT_FAILURE;
+    printf("%zu positions from %d games, wrote %s (%.1f s)\n", data.count, n_games, out,
+           search_now() - t0);
+
+    free(w);
+    tune_set_free(&data);
+    tt_free();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,260 @@
+/*
+g++ -O2 -Iinclude src/perft.c src/game.c -o perft
+./perft -d 6              # 시작 배치(init_board)에서 depth 1..6
+./perft -d 5 -b -s B      # 8줄 보드를 stdin 으로 입력, B 차례부터
+./perft -d 4 --check      # 따로 둔 char 보드 기준 구현과 node 수 / 국면 교차 검증
+*/
+
+#include "../include/game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static int check_mode = 0;
+static long check_errors = 0;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// -----------------------------------------------------------------------------
+//  --check 기준 구현: char 보드 scan loop
+//  game.c 의 Move/hasValidMove 는 이제 bitboard 위의 adapter 라서 비교 상대가 못 된다.
+//  bitboard 이전의 원래 규칙 코드(인접/2칸 scan, 주변 8칸 뒤집기)를 여기에 따로 둔다.
+// -----------------------------------------------------------------------------
+static int ref_on_board(int r, int c) {
+    return r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE;
+}
+
+static int ref_game_over(char board[BOARD_SIZE][BOARD_SIZE]) {
+    int dot = 0, red = 0, blue = 0;
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        for (int j = 0; j < BOARD_SIZE; j++) {
+            if (board[i][j] == '.') dot++;
+            else if (board[i][j] == 'R') red++;
+            else if (board[i][j] == 'B') blue++;
+        }
+    }
+    return dot == 0 || red == 0 || blue == 0;
+}
+
+/*
+ * 둘 수 있는 수를 전부 나열한다. clone 은 어느 돌에서 복제해도 결과가 같으므로
+ * 목적지마다 하나 (generate_moves 와 같은 규칙), jump 는 (출발, 도착) 쌍마다 하나.
+ */
+static int ref_moves(char board[BOARD_SIZE][BOARD_SIZE], char player, PackedMove *out) {
+    int n = 0;
+    char cloned[BOARD_SIZE * BOARD_SIZE] = { 0 };
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        for (int j = 0; j < BOARD_SIZE; j++) {
+            if (board[i][j] != player) continue;
+            for (int d = 0; d < 8; d++) {
+                int nr = i + directions[d][0], nc = j + directions[d][1];
+                if (ref_on_board(nr, nc) && board[nr][nc] == '.' && !cloned[BB_SQ(nr, nc)]) {
+                    cloned[BB_SQ(nr, nc)] = 1;
+                    out[n++] = MV_PACK(BB_SQ(i, j), BB_SQ(nr, nc), 0);
+                }
+            }
+            for (int d = 0; d < 8; d++) {
+                int nr = i + 2 * directions[d][0], nc = j + 2 * directions[d][1];
+                if (ref_on_board(nr, nc) && board[nr][nc] == '.')
+                    out[n++] = MV_PACK(BB_SQ(i, j), BB_SQ(nr, nc), 1);
+            }
+        }
+    }
+    return n;
+}
+
+// 원래 Move: 목적지에 복사하고 (jump 면 출발지를 비움) 주변 8칸의 상대 돌을 뒤집는다
+static void ref_move(char board[BOARD_SIZE][BOARD_SIZE], PackedMove mv) {
+    int r1 = BB_ROW(MV_FROM(mv)), c1 = BB_COL(MV_FROM(mv));
+    int r2 = BB_ROW(MV_TO(mv)), c2 = BB_COL(MV_TO(mv));
+    char me = board[r1][c1];
+    board[r2][c2] = me;
+    if (MV_JUMP(mv)) board[r1][c1] = '.';
+    for (int k = 0; k < 8; k++) {
+        int nr = r2 + directions[k][0], nc = c2 + directions[k][1];
+        if (ref_on_board(nr, nc) && board[nr][nc] != '.' && board[nr][nc] != '#' &&
+            board[nr][nc] != me)
+            board[nr][nc] = me;
+    }
+}
+
+// 기준 구현만으로 센 perft (bitboard 쪽 perft 와 같은 pass / 종료 규칙)
+static uint64_t ref_perft(char board[BOARD_SIZE][BOARD_SIZE], char player, int depth) {
+    if (depth == 0 || ref_game_over(board)) return 1;
+
+    char opp = (player == 'R') ? 'B' : 'R';
+    PackedMove moves[MAX_MOVES];
+    int n = ref_moves(board, player, moves);
+    if (n == 0) {
+        if (ref_moves(board, opp, moves) == 0) return 1;
+        return ref_perft(board, opp, depth - 1);
+    }
+
+    uint64_t nodes = 0;
+    for (int i = 0; i < n; i++) {
+        char next[BOARD_SIZE][BOARD_SIZE];
+        memcpy(next, board, sizeof(next));
+        ref_move(next, moves[i]);
+        nodes += ref_perft(next, opp, depth - 1);
+    }
+    return nodes;
+}
+
+// clone 은 목적지만, jump 는 출발지까지 같으면 같은 수
+static int same_move(PackedMove a, PackedMove b) {
+    if (MV_JUMP(a) != MV_JUMP(b) || MV_TO(a) != MV_TO(b)) return 0;
+    return !MV_JUMP(a) || MV_FROM(a) == MV_FROM(b);
+}
+
+// 한 국면에서 종료 판정과 수 목록이 기준 구현과 같은지
+static void check_node(const BitBoard *bb, char player, const MoveList *list) {
+    char board[BOARD_SIZE][BOARD_SIZE];
+    bb_to_board(bb, board);
+    if (ref_game_over(board) != bb_is_game_over(bb)) {
+        fprintf(stderr, "[check] game-over mismatch\n");
+        check_errors++;
+    }
+    PackedMove moves[MAX_MOVES];
+    int n = ref_moves(board, player, moves);
+    if (n != list->count) {
+        fprintf(stderr, "[check] %c: %d moves, reference %d\n", player, list->count, n);
+        check_errors++;
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        int found = 0;
+        for (int k = 0; k < n && !found; k++) found = same_move(list->moves[i], moves[k]);
+        if (!found) {
+            fprintf(stderr, "[check] %c: move %d->%d not in reference\n", player,
+                    MV_FROM(list->moves[i]), MV_TO(list->moves[i]));
+            check_errors++;
+        }
+    }
+}
+
+// make_move 결과 국면과 Zobrist 키를 기준 구현으로 둔 결과와 비교
+static void check_move(const BitBoard *before, const BitBoard *after, PackedMove mv) {
+    char board[BOARD_SIZE][BOARD_SIZE], expect[BOARD_SIZE][BOARD_SIZE];
+    bb_to_board(before, expect);
+    ref_move(expect, mv);
+    bb_to_board(after, board);
+    if (memcmp(board, expect, sizeof(board)) != 0) {
+        fprintf(stderr, "[check] board mismatch after %d->%d\n", MV_FROM(mv), MV_TO(mv));
+        check_errors++;
+    }
+    if (after->key != bb_compute_key(after)) {
+        fprintf(stderr, "[check] zobrist key drift after %d->%d\n", MV_FROM(mv), MV_TO(mv));
+        check_errors++;
+    }
+}
+
+/*
+ * depth 0 이나 게임 종료 국면이 leaf.
+ * 수가 없으면 pass 도 한 수로 센다; 양쪽 모두 수가 없으면(연속 pass) 종료.
+ */
+static uint64_t perft(BitBoard *bb, int depth) {
+    if (depth == 0 || bb_is_game_over(bb)) return 1;
+
+    char player = bb_side(bb);
+    MoveList list;
+    int n = generate_moves(bb, player, &list);
+    if (check_mode) check_node(bb, player, &list);
+
+    if (n == 0) {
+        char opp = (player == 'R') ? 'B' : 'R';
+        if (!bb_has_valid_move(bb, opp)) return 1;
+        bb_pass(bb);
+        uint64_t nodes = perft(bb, depth - 1);
+        bb_pass(bb);
+        return nodes;
+    }
+
+    uint64_t nodes = 0;
+    for (int i = 0; i < n; i++) {
+        MoveUndo undo;
+        BitBoard before = *bb;
+        make_move(bb, player, MV_FROM(list.moves[i]), MV_TO(list.moves[i]), &undo);
+        if (check_mode) check_move(&before, bb, list.moves[i]);
+        nodes += perft(bb, depth - 1);
+        unmake_move(bb, &undo);
+    }
+    return nodes;
+}
+
+static int read_board(char board[BOARD_SIZE][BOARD_SIZE]) {
+    char line[64];
+    printf("<8 lines>: board state (each line has 8 characters: R, B, ., or #).\n");
+    for (int i = 0; i < BOARD_SIZE; ++i) {
+        if (scanf("%63s", line) != 1 || strlen(line) != BOARD_SIZE) {
+            fprintf(stderr, "[Error] 보드 입력 실패 (line %d)\n", i + 1);
+            return -1;
+        }
+        memcpy(board[i], line, BOARD_SIZE);
+    }
+    if (!isValidInput(board, 0, 0, 0, 0)) {
+        fprintf(stderr, "[Error] 잘못된 문자가 포함된 보드\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int max_depth = 5;
+    int from_stdin = 0;
+    char side = 'R';
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            max_depth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-b") == 0)
+            from_stdin = 1;
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            side = argv[++i][0];
+        else if (strcmp(argv[i], "--check") == 0)
+            check_mode = 1;
+        else {
+            printf("Usage: %s [-d depth] [-b] [-s R|B] [--check]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    char board[BOARD_SIZE][BOARD_SIZE];
+    if (from_stdin) {
+        if (read_board(board) < 0) return EXIT_FAILURE;
+    } else {
+        init_board(board);
+    }
+
+    side = (side == 'B') ? 'B' : 'R';
+    BitBoard bb;
+    bb_from_board(&bb, board);
+    bb_set_side(&bb, side);
+
+    printf("%-6s %16s %10s %14s%s\n", "depth", "nodes", "sec", "nodes/sec",
+           check_mode ? "        reference" : "");
+    for (int d = 1; d <= max_depth; ++d) {
+        double t0 = now_sec();
+        uint64_t nodes = perft(&bb, d);
+        double dt = now_sec() - t0;
+        printf("%-6d %16llu %10.3f %14.0f", d, (unsigned long long)nodes, dt,
+               dt > 0 ? nodes / dt : 0.0);
+        if (check_mode) {
+            // node 수는 기준 구현만으로 따로 센 값과 같아야 한다
+            uint64_t ref = ref_perft(board, side, d);
+            printf(" %16llu", (unsigned long long)ref);
+            if (ref != nodes) check_errors++;
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+    if (check_mode) {
+        printf("check: %ld mismatch(es)\n", check_errors);
+        return check_errors ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,344 @@
+#include "../include/search.h"
+#include "../include/tt.h"
+#include "../include/pattern.h"
+#include "../include/nnue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#define CHECK_EVERY 1023     // 노드 1024 개마다 시계/중단 플래그 확인
+#define HISTORY_MAX (1 << 24)
+
+// 수 정렬 점수: hash move > killer 1 > killer 2 > history
+#define ORDER_HASH    (1 << 30)
+#define ORDER_KILLER1 (1 << 29)
+#define ORDER_KILLER2 (ORDER_KILLER1 - 1)
+
+// 스레드별 정렬 테이블. history 는 턴 사이에 절반으로 줄여(aging) 이어서 쓴다
+typedef struct {
+    PackedMove killers[SEARCH_MAX_DEPTH + 1][2];
+    int history[64][64];           // butterfly: [from][to]
+} OrderTables;
+
+static OrderTables order_tables[SEARCH_MAX_THREADS];
+
+typedef struct {
+    double deadline;
+    uint64_t nodes;
+    int stopped;
+    int *abort_flag;     // 스레드 공용: 메인 스레드가 끝나면 helper 들도 멈춤
+    int *stop_flag;      // 호출자 쪽 중단 요청 (없으면 abort_flag 와 같음)
+    OrderTables *order;
+    PatternState ps[SEARCH_MAX_DEPTH + 2];   // ply 별 패턴 index (EVAL_PATTERN 일 때만 갱신)
+    NnueState nn[SEARCH_MAX_DEPTH + 2];      // ply 별 accumulator (EVAL_NNUE 일 때만 갱신)
+} SearchCtx;
+
+// Lazy SMP helper 한 개의 작업
+typedef struct {
+    pthread_t tid;
+    int id;
+    SearchCtx ctx;
+    BitBoard bb;
+    char player;
+    MoveList list;
+    int max_depth;
+} HelperArgs;
+
+static int search_threads = 1;
+static int eval_kind = EVAL_SIMPLE;
+
+void search_set_threads(int n) {
+    if (n < 1) n = 1;
+    if (n > SEARCH_MAX_THREADS) n = SEARCH_MAX_THREADS;
+    search_threads = n;
+}
+
+int search_set_eval(int kind) {
+    if (kind == EVAL_PATTERN && pattern_init() < 0) return -1;
+    if (kind == EVAL_NNUE && !nnue_loaded()) {
+        fprintf(stderr, "nnue weights not loaded\n");
+        return -1;
+    }
+    eval_kind = kind;
+    return 0;
+}
+
+double search_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 종국: 돌 차이가 곧 결과, 이기면 SCORE_WIN 이상
+static int final_score(const BitBoard *bb, char me) {
+    int diff = bb_popcount(bb_own(bb, me)) - bb_popcount(bb_opp(bb, me));
+    if (diff > 0) return SCORE_WIN + diff;
+    if (diff < 0) return -SCORE_WIN + diff;
+    return 0;
+}
+
+// 정적 평가: 돌 차이(또는 패턴 테이블 / NNUE) + 다음 수로 닿을 수 있는 빈칸 수 차이
+static int evaluate(const SearchCtx *ctx, const BitBoard *bb, char me, int ply) {
+    uint64_t own = bb_own(bb, me), opp = bb_opp(bb, me), empty = bb_empty(bb);
+    int mob = bb_popcount((bb_adjacent(own) | bb_jump_targets(own)) & empty)
+            - bb_popcount((bb_adjacent(opp) | bb_jump_targets(opp)) & empty);
+    if (eval_kind == EVAL_PATTERN) return pattern_eval_state(&ctx->ps[ply], bb, me) + mob;
+    if (eval_kind == EVAL_NNUE) return nnue_eval_state(&ctx->nn[ply], me) + mob;
+    int disc = bb_popcount(own) - bb_popcount(opp);
+    return 16 * disc + mob;
+}
+
+// make_move 직후: 평가 함수의 증분 상태를 ply 에서 ply + 1 로 넘긴다.
+// unmake 는 ply 별 사본을 버리는 것으로 끝난다 (undo == NULL 이면 pass)
+static inline void eval_push(SearchCtx *ctx, int ply, char me, const MoveUndo *undo) {
+    if (eval_kind == EVAL_PATTERN) {
+        ctx->ps[ply + 1] = ctx->ps[ply];
+        if (undo) pattern_state_move(&ctx->ps[ply + 1], me, undo);
+    } else if (eval_kind == EVAL_NNUE) {
+        ctx->nn[ply + 1] = ctx->nn[ply];
+        if (undo) nnue_state_move(&ctx->nn[ply + 1], me, undo);
+    }
+}
+
+static void age_order_tables(int n_threads) {
+    for (int t = 0; t < n_threads; t++) {
+        OrderTables *o = &order_tables[t];
+        memset(o->killers, 0, sizeof(o->killers));
+        for (int f = 0; f < 64; f++)
+            for (int to = 0; to < 64; to++)
+                o->history[f][to] >>= 1;
+    }
+}
+
+// beta 컷을 낸 수: killer 갱신 + history 에 depth^2 가산
+static void record_cutoff(OrderTables *o, PackedMove mv, int depth, int ply) {
+    if (o->killers[ply][0] != mv) {
+        o->killers[ply][1] = o->killers[ply][0];
+        o->killers[ply][0] = mv;
+    }
+    int *h = &o->history[MV_FROM(mv)][MV_TO(mv)];
+    *h += depth * depth;
+    if (*h > HISTORY_MAX) {
+        for (int f = 0; f < 64; f++)
+            for (int to = 0; to < 64; to++)
+                o->history[f][to] >>= 1;
+    }
+}
+
+static void score_moves(const OrderTables *o, const MoveList *list, PackedMove hash_move,
+                        int ply, int *scores) {
+    PackedMove k1 = o->killers[ply][0], k2 = o->killers[ply][1];
+    for (int i = 0; i < list->count; i++) {
+        PackedMove mv = list->moves[i];
+        if (mv == hash_move)  scores[i] = ORDER_HASH;
+        else if (mv == k1)    scores[i] = ORDER_KILLER1;
+        else if (mv == k2)    scores[i] = ORDER_KILLER2;
+        else                  scores[i] = o->history[MV_FROM(mv)][MV_TO(mv)];
+    }
+}
+
+// 남은 수 중 점수가 가장 높은 것을 i 번째로 (컷이 나면 나머지는 정렬할 필요 없음)
+static inline void pick_next(MoveList *list, int *scores, int i) {
+    int best = i;
+    for (int j = i + 1; j < list->count; j++)
+        if (scores[j] > scores[best]) best = j;
+    if (best != i) {
+        PackedMove m = list->moves[i]; list->moves[i] = list->moves[best]; list->moves[best] = m;
+        int sc = scores[i]; scores[i] = scores[best]; scores[best] = sc;
+    }
+}
+
+static int negamax(SearchCtx *ctx, BitBoard *bb, int depth, int ply, int alpha, int beta) {
+    if ((++ctx->nodes & CHECK_EVERY) == 0 &&
+        (search_now() >= ctx->deadline ||
+         __atomic_load_n(ctx->abort_flag, __ATOMIC_RELAXED) ||
+         __atomic_load_n(ctx->stop_flag, __ATOMIC_RELAXED)))
+        ctx->stopped = 1;
+    if (ctx->stopped) return 0;
+
+    char me = bb_side(bb);
+    if (bb_is_game_over(bb)) return final_score(bb, me);
+    if (depth <= 0) return evaluate(ctx, bb, me, ply);
+
+    // TT: 충분히 깊은 결과면 바로 컷, 아니어도 hash move 는 먼저 둔다
+    int alpha_orig = alpha;
+    PackedMove hash_move = MV_NONE;
+    TTHit hit;
+    if (tt_probe(bb->key, &hit)) {
+        hash_move = hit.move;
+        if (hit.depth >= depth) {
+            if (hit.bound == TT_EXACT) return hit.score;
+            if (hit.bound == TT_LOWER && hit.score >= beta) return hit.score;
+            if (hit.bound == TT_UPPER && hit.score <= alpha) return hit.score;
+        }
+    }
+
+    MoveList list;
+    int n = generate_moves(bb, me, &list);
+    if (n == 0) {
+        // pass, 상대도 둘 곳이 없으면 연속 pass 로 종료
+        if (!bb_has_valid_move(bb, me == 'R' ? 'B' : 'R')) return final_score(bb, me);
+        bb_pass(bb);
+        eval_push(ctx, ply, me, NULL);
+        int v = -negamax(ctx, bb, depth - 1, ply + 1, -beta, -alpha);
+        bb_pass(bb);
+        return v;
+    }
+    int scores[MAX_MOVES];
+    score_moves(ctx->order, &list, hash_move, ply, scores);
+
+    int best = -SCORE_INF;
+    PackedMove best_move = MV_NONE;
+    for (int i = 0; i < n; i++) {
+        pick_next(&list, scores, i);
+        MoveUndo undo;
+        make_move(bb, me, MV_FROM(list.moves[i]), MV_TO(list.moves[i]), &undo);
+        eval_push(ctx, ply, me, &undo);
+        int v = -negamax(ctx, bb, depth - 1, ply + 1, -beta, -alpha);
+        unmake_move(bb, &undo);
+        if (ctx->stopped) return 0;
+        if (v > best) { best = v; best_move = list.moves[i]; }
+        if (v > alpha) alpha = v;
+        if (alpha >= beta) {
+            record_cutoff(ctx->order, list.moves[i], depth, ply);
+            break;
+        }
+    }
+
+    int bound = best <= alpha_orig ? TT_UPPER : best >= beta ? TT_LOWER : TT_EXACT;
+    tt_store(bb->key, depth, best, bound, best_move);
+    return best;
+}
+
+// root 한 iteration. 끝까지 돌았으면 1 과 함께 best_idx/score 를 채운다
+static int search_iteration(SearchCtx *ctx, BitBoard *bb, char player,
+                            const MoveList *list, int depth, int *best_idx, int *best_score) {
+    int alpha = -SCORE_INF, beta = SCORE_INF;
+    *best_idx = 0;
+    *best_score = -SCORE_INF;
+    for (int i = 0; i < list->count; i++) {
+        MoveUndo undo;
+        make_move(bb, player, MV_FROM(list->moves[i]), MV_TO(list->moves[i]), &undo);
+        eval_push(ctx, 0, player, &undo);
+        int v = -negamax(ctx, bb, depth - 1, 1, -beta, -alpha);
+        unmake_move(bb, &undo);
+        if (ctx->stopped) return 0;
+        if (v > *best_score) { *best_score = v; *best_idx = i; }
+        if (v > alpha) alpha = v;
+    }
+    return 1;
+}
+
+static void move_to_front(MoveList *list, int idx) {
+    PackedMove m = list->moves[idx];
+    memmove(&list->moves[1], &list->moves[0], idx * sizeof(PackedMove));
+    list->moves[0] = m;
+}
+
+/*
+ * Lazy SMP helper: 같은 root 를 공유 TT 위에서 탐색한다.
+ * 홀수 번 helper 는 depth 를 하나 건너뛰고, root 수 순서도 id 만큼 돌려서
+ * 메인 스레드와 다른 가지를 먼저 채우게 한다. 결과는 TT 로만 전달.
+ */
+static void *helper_main(void *arg) {
+    HelperArgs *h = (HelperArgs *)arg;
+    int n = h->list.count;
+    for (int k = 0; k < h->id % n; k++) move_to_front(&h->list, n - 1);
+
+    for (int depth = 1 + (h->id & 1); depth <= h->max_depth; depth += 1 + (h->id & 1)) {
+        int best_idx, best_score;
+        if (!search_iteration(&h->ctx, &h->bb, h->player, &h->list, depth, &best_idx, &best_score))
+            break;
+        tt_store(h->bb.key, depth, best_score, TT_EXACT, h->list.moves[best_idx]);
+        move_to_front(&h->list, best_idx);
+    }
+    return NULL;
+}
+
+/*
+ * iterative deepening: depth 1 부터 deadline 까지.
+ * 중간에 끊긴 iteration 은 버리고, 마지막으로 완료된 결과만 돌려준다.
+ * search_threads > 1 이면 helper 스레드가 같은 root 를 같이 탐색 (Lazy SMP).
+ * 반환값: 둘 수 있는 수가 있으면 1, pass 면 0
+ */
+int search_root(const BitBoard *root, char player,
+                const SearchLimits *limits, SearchResult *result) {
+    int abort_flag = 0;
+    SearchCtx ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.deadline = limits->deadline;
+    ctx.abort_flag = &abort_flag;
+    ctx.stop_flag = limits->stop ? limits->stop : &abort_flag;
+    ctx.order = &order_tables[0];
+    BitBoard bb = *root;
+    bb_set_side(&bb, player);
+    if (eval_kind == EVAL_PATTERN) pattern_state_init(&ctx.ps[0], &bb);
+    if (eval_kind == EVAL_NNUE) nnue_state_init(&ctx.nn[0], &bb);
+
+    memset(result, 0, sizeof(*result));
+    double start = search_now();
+    if (!limits->ponder) {
+        tt_new_search();
+        age_order_tables(search_threads);
+    }
+
+    MoveList list;
+    int n = generate_moves(&bb, player, &list);
+    if (n == 0) return 0;
+    result->best = list.moves[0];
+    if (n == 1) return 1;
+
+    int max_depth = limits->max_depth > 0 ? limits->max_depth : SEARCH_MAX_DEPTH;
+    double last_iter = 0.0;
+
+    // helper 의 ctx 는 ply 별 패턴 상태 때문에 커서 호출마다 힙에 잡는다 (실패하면 helper 없이 탐색)
+    HelperArgs *helpers = NULL;
+    if (search_threads > 1)
+        helpers = (HelperArgs *)malloc(sizeof(HelperArgs) * (size_t)(search_threads - 1));
+    int n_helpers = 0;
+    for (int i = 1; helpers && i < search_threads; i++) {
+        HelperArgs *h = &helpers[n_helpers];
+        h->id = i;
+        h->ctx = ctx;
+        h->ctx.order = &order_tables[i];
+        h->bb = bb;
+        h->player = player;
+        h->list = list;
+        h->max_depth = max_depth;
+        if (pthread_create(&h->tid, NULL, helper_main, h) != 0) break;
+        n_helpers++;
+    }
+
+    for (int depth = 1; depth <= max_depth; depth++) {
+        // 직전 iteration 보다 몇 배 걸릴 테니 남은 시간이 모자라면 시작하지 않음
+        double t0 = search_now();
+        if (depth > 1 && t0 + 3.0 * last_iter >= limits->deadline) break;
+
+        int best_idx, best_score;
+        if (!search_iteration(&ctx, &bb, player, &list, depth, &best_idx, &best_score))
+            break;
+
+        // 완료: 최선 수를 앞으로 (다음 iteration 에서 먼저 탐색)
+        PackedMove bm = list.moves[best_idx];
+        move_to_front(&list, best_idx);
+
+        tt_store(bb.key, depth, best_score, TT_EXACT, bm);
+        result->best = bm;
+        result->score = best_score;
+        result->depth = depth;
+        last_iter = search_now() - t0;
+        if (best_score >= SCORE_WIN || best_score <= -SCORE_WIN) break;  // 끝까지 읽음
+    }
+
+    __atomic_store_n(&abort_flag, 1, __ATOMIC_RELAXED);
+    result->nodes = ctx.nodes;
+    for (int i = 0; i < n_helpers; i++) {
+        pthread_join(helpers[i].tid, NULL);
+        result->nodes += helpers[i].ctx.nodes;
+    }
+    free(helpers);
+    result->elapsed = search_now() - start;
+    return 1;
+}
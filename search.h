@@ -0,0 +1,35 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "game.h"
+
+#define SEARCH_MAX_DEPTH  64
+#define SEARCH_MAX_THREADS 64
+#define SCORE_INF         1000000
+#define SCORE_WIN         100000     // 종국 승리 (+ 돌 차이)
+
+// 정적 평가 함수 선택
+enum { EVAL_SIMPLE = 0, EVAL_PATTERN = 1, EVAL_NNUE = 2 };
+
+typedef struct {
+    double deadline;     // search_now() 기준 절대 시각 (초)
+    int max_depth;
+    int *stop;           // 외부 중단 플래그 (pondering), NULL 이면 deadline 만
+    int ponder;          // 1 이면 같은 턴의 연장: TT/history aging 생략
+} SearchLimits;
+
+typedef struct {
+    PackedMove best;     // 마지막으로 끝까지 돈 iteration 의 최선 수, 없으면 MV_NONE
+    int score;
+    int depth;           // 완료된 최대 depth
+    uint64_t nodes;
+    double elapsed;
+} SearchResult;
+
+double search_now(void);
+void search_set_threads(int n);
+int search_set_eval(int kind);
+int search_root(const BitBoard *root, char player,
+                const SearchLimits *limits, SearchResult *result);
+
+#endif
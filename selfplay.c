@@ -0,0 +1,398 @@
+/*
+g++ -O2 -Iinclude src/selfplay.c src/search.c src/tt.c src/mcts.c src/endgame.c src/pattern.c src/nnue.c src/game.c -lpthread -o selfplay
+./selfplay -n 1000 -j 8 -m 50                    # ab vs ab, 국면마다 50ms, worker 8 개
+./selfplay -A mcts -B ab -n 200 -j 4 -m 200 -r 6 -s 7
+./selfplay -A ab -B ab --depth-a 6 --depth-b 5 -n 2000 -j 8
+./selfplay --eval-a pattern --patterns weights.pat -n 1000 -j 8 -m 50
+./selfplay --eval-a nnue --nnue weights.nnue -n 1000 -j 8 -m 50
+*/
+
+#include "../include/game.h"
+#include "../include/search.h"
+#include "../include/tt.h"
+#include "../include/mcts.h"
+#include "../include/endgame.h"
+#include "../include/pattern.h"
+#include "../include/nnue.h"
+#include "../include/tunedata.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+
+#define MAX_WORKERS  256
+#define MAX_PLIES    1000     // jump 만 반복하는 게임은 여기서 돌 수로 판정
+
+// 기대 점수 -> Elo 차
+#define ELO(s) ((s) <= 0.0 ? -INFINITY : (s) >= 1.0 ? INFINITY : -400.0 * log10(1.0 / (s) - 1.0))
+
+enum { ENG_AB, ENG_MCTS, ENG_FLIP, ENG_RANDOM };
+
+typedef struct {
+    int engine;
+    int depth;           // ab 최대 depth, 0 이면 시간만
+    int eval;            // EVAL_SIMPLE / EVAL_PATTERN / EVAL_NNUE
+} Engine;
+
+// worker -> 부모 (pipe 로 그대로 write)
+typedef struct {
+    int game;
+    int result;          // A 기준: 1 승, 0 무, -1 패
+    int plies;
+    int capped;          // MAX_PLIES 에 걸려 판정
+    int moves[2];        // [0] = A, [1] = B
+    uint64_t depth_sum[2];
+    uint64_t nodes_sum[2];
+} GameRecord;
+
+/*
+ * 엔진 하나 = 프로세스 하나. TT, 정렬 테이블, MCTS 트리는 모듈 전역이라 한 프로세스에서
+ * A/B 를 번갈아 돌리면 상대 엔진의 탐색 결과(TT, history)를 그대로 읽게 된다.
+ * 그래서 worker 가 게임마다 A, B 를 따로 fork 하고 국면을 pipe 로 주고받는다.
+ */
+typedef struct {
+    pid_t pid;
+    int to_fd;           // worker -> 엔진 (EngineRequest)
+    int from_fd;         // 엔진 -> worker (EngineReply)
+} EngineProc;
+
+typedef struct {
+    BitBoard bb;
+    char me;
+} EngineRequest;
+
+typedef struct {
+    PackedMove mv;
+    int depth;
+    uint64_t nodes;
+} EngineReply;
+
+static Engine engines[2] = { { ENG_AB, 0, EVAL_SIMPLE }, { ENG_AB, 0, EVAL_SIMPLE } };
+static int move_ms = 100;
+static int random_plies = 4;
+static uint64_t seed = 1;
+static int eg_empties = EG_DEFAULT_EMPTIES;
+static int hash_mb = 16;
+static int result_fd = -1;   // worker -> 부모, 엔진 프로세스에서는 닫는다
+
+static int parse_engine(const char *s) {
+    if (strcmp(s, "mcts") == 0)   return ENG_MCTS;
+    if (strcmp(s, "flip") == 0)   return ENG_FLIP;
+    if (strcmp(s, "random") == 0) return ENG_RANDOM;
+    return ENG_AB;
+}
+
+static int parse_eval(const char *s) {
+    if (strcmp(s, "pattern") == 0) return EVAL_PATTERN;
+    if (strcmp(s, "nnue") == 0)    return EVAL_NNUE;
+    return EVAL_SIMPLE;
+}
+
+// client.c 의 generate_move 와 같은 순서: endgame solver -> 엔진
+static PackedMove choose(const Engine *p, const BitBoard *bb, char me, const MoveList *list,
+                         uint64_t *rng, int *depth, uint64_t *nodes) {
+    double deadline = search_now() + move_ms / 1000.0;
+    *depth = 0;
+    *nodes = 0;
+    if (p->engine == ENG_RANDOM) return list->moves[next_rand(rng) % (uint64_t)list->count];
+    if (p->engine == ENG_FLIP) {
+        *depth = 1;
+        return bb_greedy_move(bb, me);
+    }
+    if (bb->n_empty <= eg_empties) {
+        EndgameResult eg;
+        endgame_solve(bb, me, deadline, &eg);
+        *depth = eg.cap;
+        *nodes = eg.nodes;
+        if (eg.cap) return eg.best;
+    }
+    if (p->engine == ENG_MCTS) {
+        MctsLimits limits = { deadline, 0, NULL };
+        MctsResult res;
+        mcts_search(bb, me, &limits, &res);
+        *nodes += res.playouts;
+        return res.best;
+    }
+    SearchLimits limits = { deadline, p->depth, NULL, 0 };
+    SearchResult res;
+    search_root(bb, me, &limits, &res);
+    *depth = res.depth;
+    *nodes += res.nodes;
+    return res.depth ? res.best : bb_greedy_move(bb, me);
+}
+
+// 엔진 프로세스: 요청마다 choose, worker 가 pipe 를 닫으면 끝
+static void engine_main(const Engine *p, uint64_t rng, int in_fd, int out_fd) {
+    search_set_threads(1);
+    mcts_set_threads(1);
+    search_set_eval(p->eval);
+    if (tt_init((size_t)hash_mb, 0) < 0) exit(EXIT_FAILURE);
+
+    EngineRequest req;
+    while (read(in_fd, &req, sizeof(req)) == (ssize_t)sizeof(req)) {
+        MoveList list;
+        EngineReply rep;
+        generate_moves(&req.bb, req.me, &list);
+        rep.mv = choose(p, &req.bb, req.me, &list, &rng, &rep.depth, &rep.nodes);
+        if (write(out_fd, &rep, sizeof(rep)) != (ssize_t)sizeof(rep)) break;
+    }
+    tt_free();
+    mcts_free();
+    exit(EXIT_SUCCESS);
+}
+
+// 게임 시작 때 새로 띄우므로 이전 게임의 TT/트리/history 도 이어받지 않는다
+static int engine_spawn(EngineProc *ep, const Engine *p, uint64_t rng, const EngineProc *other) {
+    int req[2], rep[2];
+    if (pipe(req) < 0) return -1;
+    if (pipe(rep) < 0) {
+        close(req[0]);
+        close(req[1]);
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(req[0]); close(req[1]);
+        close(rep[0]); close(rep[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(req[1]);
+        close(rep[0]);
+        close(result_fd);
+        if (other) {
+            close(other->to_fd);
+            close(other->from_fd);
+        }
+        engine_main(p, rng, req[0], rep[1]);
+    }
+    close(req[0]);
+    close(rep[1]);
+    ep->pid = pid;
+    ep->to_fd = req[1];
+    ep->from_fd = rep[0];
+    return 0;
+}
+
+static void engine_stop(EngineProc *ep) {
+    close(ep->to_fd);
+    close(ep->from_fd);
+    waitpid(ep->pid, NULL, 0);
+}
+
+static PackedMove engine_ask(const EngineProc *ep, const BitBoard *bb, char me,
+                             int *depth, uint64_t *nodes) {
+    EngineRequest req;
+    EngineReply rep;
+    memset(&req, 0, sizeof(req));
+    req.bb = *bb;
+    req.me = me;
+    if (write(ep->to_fd, &req, sizeof(req)) != (ssize_t)sizeof(req) ||
+        read(ep->from_fd, &rep, sizeof(rep)) != (ssize_t)sizeof(rep)) {
+        fprintf(stderr, "selfplay: engine process %d died\n", (int)ep->pid);
+        exit(EXIT_FAILURE);
+    }
+    *depth = rep.depth;
+    *nodes = rep.nodes;
+    return rep.mv;
+}
+
+/*
+ * game_loop 과 같은 규칙: 둘 곳이 없으면 pass, 연속 pass 2 번이면 종료.
+ * 짝수/홀수 게임은 같은 무작위 오프닝을 색만 바꿔서 둔다.
+ */
+static void play_game(int game, GameRecord *rec) {
+    memset(rec, 0, sizeof(*rec));
+    rec->game = game;
+    uint64_t rng = (seed + (uint64_t)(game / 2)) * 0x9E3779B97F4A7C15ULL;
+    if (!rng) rng = 1;
+    int a_color = (game & 1) ? 1 : 0;     // A 가 둘 side: 0 = R, 1 = B
+
+    char board[BOARD_SIZE][BOARD_SIZE];
+    init_board(board);
+    BitBoard bb;
+    bb_from_board(&bb, board);
+    bb_set_side(&bb, 'R');
+
+    EngineProc procs[2];
+    if (engine_spawn(&procs[0], &engines[0], rng ^ 0xA, NULL) < 0 ||
+        engine_spawn(&procs[1], &engines[1], rng ^ 0xB, &procs[0]) < 0) {
+        perror("selfplay: engine_spawn");
+        exit(EXIT_FAILURE);
+    }
+
+    int passes = 0;
+    for (int ply = 0; !bb_is_game_over(&bb); ply++) {
+        if (ply >= MAX_PLIES) { rec->capped = 1; break; }
+        char me = bb_side(&bb);
+        MoveList list;
+        if (generate_moves(&bb, me, &list) == 0) {
+            bb_pass(&bb);
+            if (++passes == 2) break;
+            continue;
+        }
+        passes = 0;
+
+        PackedMove mv;
+        if (ply < random_plies) {
+            mv = list.moves[next_rand(&rng) % (uint64_t)list.count];
+        } else {
+            int who = (bb.side == a_color) ? 0 : 1;
+            int depth;
+            uint64_t nodes;
+            mv = engine_ask(&procs[who], &bb, me, &depth, &nodes);
+            rec->moves[who]++;
+            rec->depth_sum[who] += (uint64_t)depth;
+            rec->nodes_sum[who] += nodes;
+        }
+        bb_move(&bb, me, MV_FROM(mv), MV_TO(mv));
+        rec->plies++;
+    }
+    engine_stop(&procs[0]);
+    engine_stop(&procs[1]);
+
+    int diff = (int)bb.n_red - (int)bb.n_blue;
+    if (a_color) diff = -diff;
+    rec->result = diff > 0 ? 1 : diff < 0 ? -1 : 0;
+}
+
+static void worker_main(int id, int n_workers, int n_games, int fd) {
+    result_fd = fd;
+    for (int g = id; g < n_games; g += n_workers) {
+        GameRecord rec;
+        play_game(g, &rec);
+        if (write(fd, &rec, sizeof(rec)) != (ssize_t)sizeof(rec)) exit(EXIT_FAILURE);
+    }
+    close(fd);
+    exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char *argv[]) {
+    int n_games = 100;
+    int n_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-A") == 0 && i + 1 < argc)
+            engines[0].engine = parse_engine(argv[++i]);
+        else if (strcmp(argv[i], "-B") == 0 && i + 1 < argc)
+            engines[1].engine = parse_engine(argv[++i]);
+        else if (strcmp(argv[i], "--depth-a") == 0 && i + 1 < argc)
+            engines[0].depth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--depth-b") == 0 && i + 1 < argc)
+            engines[1].depth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--eval-a") == 0 && i + 1 < argc)
+            engines[0].eval = parse_eval(argv[++i]);
+        else if (strcmp(argv[i], "--eval-b") == 0 && i + 1 < argc)
+            engines[1].eval = parse_eval(argv[++i]);
+        else if (strcmp(argv[i], "--patterns") == 0 && i + 1 < argc) {
+            if (pattern_load(argv[++i]) < 0) return EXIT_FAILURE;
+        }
+        else if (strcmp(argv[i], "--nnue") == 0 && i + 1 < argc) {
+            if (nnue_load(argv[++i]) < 0) return EXIT_FAILURE;
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            n_games = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            n_workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+            move_ms = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            random_plies = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--endgame") == 0 && i + 1 < argc)
+            eg_empties = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hash") == 0 && i + 1 < argc)
+            hash_mb = atoi(argv[++i]);
+        else {
+            printf("Usage: %s [-A ab|mcts|flip|random] [-B ...] [--depth-a N] [--depth-b N]\n"
+                   "          [-n games] [-j workers] [-m ms/move] [-r random plies] [-s seed]\n"
+                   "          [--eval-a simple|pattern|nnue] [--eval-b ...] [--patterns file] [--nnue file]\n"
+                   "          [--endgame empties] [--hash MB]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((engines[0].eval == EVAL_NNUE || engines[1].eval == EVAL_NNUE) && search_set_eval(EVAL_NNUE) < 0)
+        return EXIT_FAILURE;
+    if (n_workers < 1) n_workers = 1;
+    if (n_workers > MAX_WORKERS) n_workers = MAX_WORKERS;
+    if (n_workers > n_games) n_workers = n_games > 0 ? n_games : 1;
+
+    // worker 는 게임을 나눠 돌리는 프로세스, 엔진 상태는 그 아래 게임별 엔진 프로세스가 가진다
+    struct pollfd fds[MAX_WORKERS];
+    pid_t pids[MAX_WORKERS];
+    double t0 = search_now();
+    for (int w = 0; w < n_workers; w++) {
+        int p[2];
+        if (pipe(p) < 0) { perror("pipe"); return EXIT_FAILURE; }
+        pid_t pid = fork();
+        if (pid < 0) { perror("fork"); return EXIT_FAILURE; }
+        if (pid == 0) {
+            close(p[0]);
+            for (int k = 0; k < w; k++) close(fds[k].fd);
+            worker_main(w, n_workers, n_games, p[1]);
+        }
+        close(p[1]);
+        pids[w] = pid;
+        fds[w].fd = p[0];
+        fds[w].events = POLLIN;
+    }
+
+    int wins = 0, draws = 0, losses = 0, capped = 0, done = 0, open_fds = n_workers;
+    uint64_t plies = 0, moves[2] = { 0, 0 }, depth_sum[2] = { 0, 0 }, nodes_sum[2] = { 0, 0 };
+    while (open_fds > 0) {
+        if (poll(fds, (nfds_t)n_workers, -1) < 0) { perror("poll"); break; }
+        for (int w = 0; w < n_workers; w++) {
+            if (fds[w].fd < 0 || !(fds[w].revents & (POLLIN | POLLHUP))) continue;
+            GameRecord rec;
+            ssize_t r = read(fds[w].fd, &rec, sizeof(rec));
+            if (r != (ssize_t)sizeof(rec)) {
+                close(fds[w].fd);
+                fds[w].fd = -1;
+                open_fds--;
+                continue;
+            }
+            if (rec.result > 0) wins++;
+            else if (rec.result < 0) losses++;
+            else draws++;
+            capped += rec.capped;
+            plies += (uint64_t)rec.plies;
+            for (int k = 0; k < 2; k++) {
+                moves[k] += (uint64_t)rec.moves[k];
+                depth_sum[k] += rec.depth_sum[k];
+                nodes_sum[k] += rec.nodes_sum[k];
+            }
+            if (++done % 10 == 0) {
+                fprintf(stderr, "\r%d/%d games  +%d =%d -%d", done, n_games, wins, draws, losses);
+            }
+        }
+    }
+    for (int w = 0; w < n_workers; w++) waitpid(pids[w], NULL, 0);
+    double dt = search_now() - t0;
+    if (done >= 10) fprintf(stderr, "\n");
+
+    int n = wins + draws + losses;
+    if (n == 0) {
+        fprintf(stderr, "no games finished\n");
+        return EXIT_FAILURE;
+    }
+    // 게임당 점수(1, 0.5, 0)의 평균과 95% 신뢰구간, 이를 Elo 차로 환산
+    double score = (wins + 0.5 * draws) / n;
+    double var = (wins * (1.0 - score) * (1.0 - score) + draws * (0.5 - score) * (0.5 - score) +
+                  losses * score * score) / n;
+    double ci = 1.96 * sqrt(var / n);
+    double lo = score - ci, hi = score + ci;
+
+    printf("%d games, %.1f s, %.2f games/sec, %.1f plies/game, %d adjudicated at %d plies\n",
+           n, dt, n / dt, (double)plies / n, capped, MAX_PLIES);
+    printf("A: +%d =%d -%d  score %.3f +/- %.3f (95%%)  Elo %+.0f [%+.0f, %+.0f]\n",
+           wins, draws, losses, score, ci, ELO(score), ELO(lo), ELO(hi));
+    for (int k = 0; k < 2; k++)
+        printf("%c: %.2f avg depth, %.0f avg nodes/move\n", 'A' + k,
+               moves[k] ? (double)depth_sum[k] / moves[k] : 0.0,
+               moves[k] ? (double)nodes_sum[k] / moves[k] : 0.0);
+    return EXIT_SUCCESS;
+}
@@ -6,34 +6,109 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <signal.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
 #include <netdb.h>
 #include <arpa/inet.h>
-#include <pthread.h>
 
-static GameState game;
-static int global_listen_fd;
+#define CONN_MAX_MSG 4096    // 접속별 JSON 한 줄 최대 길이 (넘으면 연결을 끊음)
+#define CONN_OUTQ  64        // 접속별 출력 큐 길이 (꽉 차면 안 읽는 클라이언트로 보고 끊음)
+#define CONN_IOV   16        // flush 한 번에 sendmsg 로 묶는 메시지 수
+#define MAX_EVENTS 64
+#define REGISTER_TIMEOUT 10.0  // 접속 후 register 를 보낼 때까지 (초), 넘으면 nack 후 끊음
+
+/*
+ * 접속 하나의 상태:
+ *   REGISTERING : 접속 직후, register 를 기다림 (REGISTER_TIMEOUT 안에)
+ *   LOBBY       : register_ack 를 받고 상대를 기다림 (FIFO 로 두 명씩 매칭)
+ *   PLAYING     : 판 진행 중 (match / seat 가 유효)
+ *   DRAINING    : 더 받지 않고, 출력 큐(game_over, nack 등)를 다 보내면 닫음
+ *   CLOSED      : 소켓은 닫혔고 이번 epoll batch 가 끝나면 pool 로 돌아감
+ *
+ * 소켓은 비차단이다. 보낼 메시지는 JsonMsg 참조로 출력 큐에 걸고, 큐가 비어 있었으면
+ * 바로 보내 보고 남으면 EPOLLOUT 을 켜서 이어 보낸다.
+ */
+typedef enum {
+    CONN_FREE = 0, CONN_REGISTERING, CONN_LOBBY, CONN_PLAYING, CONN_DRAINING, CONN_CLOSED
+} ConnState;
+
+struct Match;
+
+typedef struct Conn {
+    int fd;
+    ConnState state;
+    char username[32];
+    struct Match *match;
+    int seat;                    // 0 = R, 1 = B
+    JsonReader in;
+    JsonMsg *outq[CONN_OUTQ];
+    unsigned outq_head, outq_tail;   // 계속 증가, 칸은 % CONN_OUTQ
+    size_t out_off;                  // 큐 맨 앞 메시지에서 이미 보낸 바이트
+    int out_failed;                  // 쓰기 오류: 큐를 버렸고 HUP 을 기다림
+    uint32_t events;                 // 지금 epoll 에 걸려 있는 이벤트
+    double deadline;                 // REGISTERING 일 때 register 제한 시각
+    struct Conn *next;           // register 대기열 / lobby 대기열 / free list / 닫힌 접속 목록
+} Conn;
+
+// 판 하나: GameState 에 턴 타이머와 연속 pass 수를 붙인 것, 매칭될 때 할당
+typedef struct Match {
+    GameState game;
+    Conn *conns[MAX_CLIENTS];
+    int count_pass;
+    double deadline;             // 현재 차례의 제한 시각 (now_sec 기준)
+    struct Match *prev, *next;
+} Match;
+
+static Conn conn_pool[MAX_CONNS];
+static Conn *free_conns = NULL;
+static Conn *closed_conns = NULL;
+static Conn *reg_head = NULL, *reg_tail = NULL;       // accept 순서 == deadline 순서
+static Conn *lobby_head = NULL, *lobby_tail = NULL;
+static Match *matches = NULL;
+static int epoll_fd = -1;
+static int n_matches = 0;
+static JsonEncoder encoder = { NULL, JSON_WRITER_INIT, CONN_MAX_MSG };   // 모든 메시지를 여기서 직렬화
 
 void init_game(GameState *game);
-void broadcast_json(const cJSON *msg);
-void send_to_client(int sockfd, const cJSON *msg);
+static double now_sec(void);
+static void send_to_client(Conn *c, const cJSON *msg);
+static void send_reason(Conn *c, const char *type, const char *reason);
+static void broadcast_json(Match *m, const cJSON *msg);
 static cJSON *board_to_json(const GameState *game);
 static int create_listen_socket(const char *port);
-static void *reject_late_clients(void *arg);
-static int accept_and_register(int listen_fd);
-static void game_loop(void);
+static void accept_clients(int listen_fd);
+static void conn_close(Conn *c);
+static void conn_finish(Conn *c);
+static void conn_fail(Conn *c);
+static void conn_set_events(Conn *c);
+static void conn_send(Conn *c, JsonMsg *msg);
+static void conn_flush(Conn *c);
+static void conn_read(Conn *c);
+static void handle_register(Conn *c, const cJSON *req);
+static void reg_push(Conn *c);
+static void reg_remove(Conn *c);
+static void reg_expire(double now);
+static void lobby_push(Conn *c);
+static void lobby_remove(Conn *c);
+static void match_start(Conn *red, Conn *blue);
+static void match_prompt(Match *m);
+static void match_pass(Match *m);
+static void match_move(Match *m, const cJSON *req);
+static void match_end(Match *m);
 int server_run(const char *port);
 
 
 void init_game(GameState *game) {
     game->current_turn = 0; // Red's turn
-    memset(game->board, '.', sizeof(game->board));
-    game->board[0][0] = 'R';
-    game->board[0][BOARD_SIZE - 1] = 'B';
-    game->board[BOARD_SIZE - 1][0] = 'B';
-    game->board[BOARD_SIZE - 1][BOARD_SIZE - 1] = 'R';
+    init_board(game->board);
+    bb_from_board(&game->bb, game->board);
     for (int i = 0; i < MAX_CLIENTS; i++) {
         game->players[i].socket = -1;
         game->players[i].username[0] = '\0';
@@ -41,22 +116,48 @@ void init_game(GameState *game) {
         game->players[i].registered = 0;
     }
 }
-void broadcast_json(const cJSON *msg) {
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (send_json(game.players[i].socket, msg) < 0) {
-        }
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+static void send_to_client(Conn *c, const cJSON *msg) {
+    JsonMsg *out = json_msg_encode(&encoder, msg);
+    if (!out) {
+        fprintf(stderr, "send_to_client: cannot encode message\n");
+        return;
     }
+    conn_send(c, out);
+    json_msg_unref(out);
+}
+// {"type": type, "reason": reason} 한 줄 응답
+static void send_reason(Conn *c, const char *type, const char *reason) {
+    cJSON *msg = cJSON_CreateObject();
+    cJSON_AddStringToObject(msg, "type", type);
+    cJSON_AddStringToObject(msg, "reason", reason);
+    send_to_client(c, msg);
+    cJSON_Delete(msg);
 }
-void send_to_client(int sockfd, const cJSON *msg) {
-    if (send_json(sockfd, msg) < 0) {
-        perror("send_json");
+// 같은 판의 두 플레이어에게 (이미 나간 자리는 건너뜀). 직렬화는 한 번만, 버퍼는 참조로 공유
+static void broadcast_json(Match *m, const cJSON *msg) {
+    JsonMsg *out = json_msg_encode(&encoder, msg);
+    if (!out) {
+        fprintf(stderr, "broadcast_json: cannot encode message\n");
+        return;
     }
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        if (m->conns[i]) conn_send(m->conns[i], out);
+    }
+    json_msg_unref(out);
 }
 static cJSON *board_to_json(const GameState *game) {
     cJSON *arr = cJSON_CreateArray();
     for (int i = 0; i < BOARD_SIZE; i++) {
-        cJSON *row = cJSON_CreateString(game->board[i]);
-        cJSON_AddItemToArray(arr, row);
+        // board 의 행은 '\0' 으로 끝나지 않으므로 (바로 뒤가 bb) 8 칸씩 잘라 문자열로 만든다
+        char line[BOARD_SIZE + 1];
+        memcpy(line, game->board[i], BOARD_SIZE);
+        line[BOARD_SIZE] = '\0';
+        cJSON_AddItemToArray(arr, cJSON_CreateString(line));
     }
     return arr;
 }
@@ -83,257 +184,485 @@ static int create_listen_socket(const char *port) {
     }
     freeaddrinfo(res);
     if (!p) return -1;
-    if (listen(listen_fd, MAX_CLIENTS) < 0) {
+    if (listen(listen_fd, SOMAXCONN) < 0) {
         perror("listen");
         close(listen_fd);
         return -1;
     }
+    // accept 는 epoll 이 깨운 뒤 EAGAIN 까지 반복
+    fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL, 0) | O_NONBLOCK);
     return listen_fd;
 }
-static int accept_and_register(int listen_fd) {
-    int registered = 0;
-    while (registered < MAX_CLIENTS) {
+
+// -----------------------------------------------------------------------------
+//  접속 관리
+// -----------------------------------------------------------------------------
+static void accept_clients(int listen_fd) {
+    while (1) {
         struct sockaddr_storage addr;
         socklen_t addrlen = sizeof(addr);
-        int client_fd = accept(global_listen_fd, (struct sockaddr*)&addr, &addrlen);
+        int client_fd = accept(listen_fd, (struct sockaddr*)&addr, &addrlen);
         if (client_fd < 0) {
-            perror("accept");
-            continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) perror("accept");
+            return;
         }
 
-
-        if (registered >= MAX_CLIENTS) {
+        Conn *c = free_conns;
+        if (!c) {
+            // 큐를 걸 Conn 이 없으니 새 소켓에 바로 한 번 써 보고 닫는다
             cJSON *nack = cJSON_CreateObject();
             cJSON_AddStringToObject(nack, "type", "register_nack");
-            cJSON_AddStringToObject(nack, "reason", "game is already running");
-            send_to_client(client_fd, nack);
+            cJSON_AddStringToObject(nack, "reason", "server is full");
+            JsonMsg *out = json_msg_encode(&encoder, nack);
+            if (out) {
+                json_send_all(client_fd, out->data, out->len);
+                json_msg_unref(out);
+            }
             cJSON_Delete(nack);
             close(client_fd);
             continue;
         }
-
-        /* 클라이언트로부터 JSON 한 줄을 읽기 */
-        cJSON *req = recv_json(client_fd);
-        if (!req) {
+        free_conns = c->next;
+        memset(c, 0, sizeof(*c));
+        c->fd = client_fd;
+        c->state = CONN_REGISTERING;
+        c->events = EPOLLIN | EPOLLRDHUP;
+        json_set_nodelay(client_fd);
+        fcntl(client_fd, F_SETFL, fcntl(client_fd, F_GETFL, 0) | O_NONBLOCK);
+
+        struct epoll_event ev;
+        ev.events = c->events;
+        ev.data.ptr = c;
+        if (json_reader_init(&c->in, CONN_MAX_MSG) < 0 ||
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_fd, &ev) < 0) {
+            perror("accept_clients");
+            json_reader_free(&c->in);
             close(client_fd);
+            c->state = CONN_FREE;
+            c->next = free_conns;
+            free_conns = c;
             continue;
         }
+        c->deadline = now_sec() + REGISTER_TIMEOUT;
+        reg_push(c);
+    }
+}
 
-        /* type 과 username 필드 검사 */
-        cJSON *jtype = cJSON_GetObjectItem(req, "type");
-        cJSON *juser = cJSON_GetObjectItem(req, "username");
-        cJSON *resp = NULL;
-
-        if (jtype && jtype->valuestring
-            && strcmp(jtype->valuestring, "register") == 0
-            && juser && juser->valuestring)
-        {
-            /* 중복 검사 */
-            int dup = 0;
-            for (int i = 0; i < registered; i++) {
-                if (strcmp(game.players[i].username,
-                           juser->valuestring) == 0)
-                {
-                    dup = 1;  break;
-                }
-            }
+// 소켓은 바로 닫고, Conn 은 이번 batch 의 다른 이벤트가 아직 가리킬 수 있으므로 나중에 회수
+static void conn_close(Conn *c) {
+    if (c->state == CONN_CLOSED || c->state == CONN_FREE) return;
+    if (c->state == CONN_REGISTERING) reg_remove(c);
+    if (c->state == CONN_LOBBY) lobby_remove(c);
+    Match *m = c->match;
+    c->state = CONN_CLOSED;
+    c->match = NULL;
+    if (m) {
+        // 판 도중 나가면 남은 쪽에 game_over 를 보내고 판을 끝낸다
+        m->conns[c->seat] = NULL;
+        match_end(m);
+    }
+    while (c->outq_head != c->outq_tail)
+        json_msg_unref(c->outq[c->outq_head++ % CONN_OUTQ]);
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->next = closed_conns;
+    closed_conns = c;
+}
+
+// 판/lobby 에서 빠진 접속을 닫는다. 아직 못 보낸 출력이 있으면 다 보낸 뒤에 닫음
+static void conn_finish(Conn *c) {
+    if (c->state == CONN_CLOSED || c->state == CONN_FREE) return;
+    if (c->outq_head == c->outq_tail || c->out_failed || c->match) {
+        conn_close(c);
+        return;
+    }
+    if (c->state == CONN_LOBBY) lobby_remove(c);
+    c->state = CONN_DRAINING;
+    conn_set_events(c);
+}
+
+/*
+ * 쓰기 오류나 큐 넘침. 판을 돌리는 도중(broadcast 루프 안)일 수 있으므로 여기서 닫지 않고
+ * 큐만 버린 뒤 shutdown 해 둔다. epoll 이 HUP 을 알려 오면 이벤트 루프에서 닫는다.
+ */
+static void conn_fail(Conn *c) {
+    while (c->outq_head != c->outq_tail)
+        json_msg_unref(c->outq[c->outq_head++ % CONN_OUTQ]);
+    c->out_off = 0;
+    c->out_failed = 1;
+    shutdown(c->fd, SHUT_RDWR);
+}
 
-            if (dup) {
-                /* 이미 존재하는 사용자 이름 */
-                resp = cJSON_CreateObject();
-                cJSON_AddStringToObject(resp, "type", "register_nack");
-                cJSON_AddStringToObject(resp, "reason", "username exists");
+// 출력이 남아 있을 때만 EPOLLOUT, DRAINING 이면 더 읽지 않는다
+static void conn_set_events(Conn *c) {
+    uint32_t events = EPOLLRDHUP;
+    if (c->state != CONN_DRAINING) events |= EPOLLIN;
+    if (c->outq_head != c->outq_tail) events |= EPOLLOUT;
+    if (events == c->events) return;
+
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.ptr = c;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &ev) == 0) c->events = events;
+}
+
+// 메시지 참조를 출력 큐에 건다. 큐가 비어 있었으면 바로 보내 본다
+static void conn_send(Conn *c, JsonMsg *msg) {
+    if (c->out_failed) return;
+    if (c->outq_tail - c->outq_head == CONN_OUTQ) {
+        fprintf(stderr, "%s: output queue full, dropping connection\n",
+                c->username[0] ? c->username : "client");
+        conn_fail(c);
+        return;
+    }
+    c->outq[c->outq_tail++ % CONN_OUTQ] = json_msg_ref(msg);
+    if (c->outq_tail - c->outq_head == 1) conn_flush(c);
+}
+
+// 큐에 쌓인 메시지를 sendmsg 한 번에 최대 CONN_IOV 개씩, EAGAIN 이 날 때까지 보낸다
+static void conn_flush(Conn *c) {
+    while (c->outq_head != c->outq_tail) {
+        struct iovec iov[CONN_IOV];
+        int cnt = 0;
+        for (unsigned i = c->outq_head; i != c->outq_tail && cnt < CONN_IOV; i++, cnt++) {
+            const JsonMsg *msg = c->outq[i % CONN_OUTQ];
+            size_t off = cnt == 0 ? c->out_off : 0;
+            iov[cnt].iov_base = msg->data + off;
+            iov[cnt].iov_len = msg->len - off;
+        }
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = iov;
+        mh.msg_iovlen = cnt;
+
+        ssize_t n = sendmsg(c->fd, &mh, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            conn_fail(c);
+            return;
+        }
+        // 다 보낸 메시지는 참조를 놓고, 중간에 끊긴 메시지는 위치만 기억한다
+        size_t sent = (size_t)n;
+        while (sent > 0) {
+            JsonMsg *msg = c->outq[c->outq_head % CONN_OUTQ];
+            size_t rest = msg->len - c->out_off;
+            if (sent < rest) {
+                c->out_off += sent;
+                break;
             }
-            else {
-                /* 정상 등록 */
-                game.players[registered].socket = client_fd;
-                strncpy(game.players[registered].username,
-                        juser->valuestring,
-                        sizeof(game.players[0].username)-1);
-                game.players[registered].username[sizeof(game.players[0].username)-1] = '\0';
-                game.players[registered].registered  = 1;
-                registered++;
-
-                resp = cJSON_CreateObject();
-                cJSON_AddStringToObject(resp, "type", "register_ack");
+            sent -= rest;
+            c->out_off = 0;
+            json_msg_unref(msg);
+            c->outq_head++;
+        }
+    }
+    if (c->state == CONN_DRAINING && c->outq_head == c->outq_tail) {
+        conn_close(c);
+        return;
+    }
+    conn_set_events(c);
+}
+
+// 읽을 수 있을 때 recv 한 번, 완성된 줄마다 상태에 맞게 처리
+static void conn_read(Conn *c) {
+    ssize_t n = json_reader_fill(&c->in, c->fd);
+    if (n <= 0) {
+        if (n < 0 && (errno == EAGAIN || errno == EINTR)) return;
+        conn_close(c);       // 연결 종료, 오류, 또는 CONN_MAX_MSG 를 넘는 줄
+        return;
+    }
+
+    while (c->state != CONN_CLOSED && c->state != CONN_DRAINING) {
+        int has_line;
+        cJSON *req = json_reader_next(&c->in, &has_line);
+        if (!has_line) {
+            if (c->in.error) conn_close(c);
+            break;
+        }
+        if (!req) continue;
+
+        if (c->state == CONN_REGISTERING) {
+            handle_register(c, req);
+        } else if (c->state == CONN_PLAYING && c->match &&
+                   c->match->game.current_turn == c->seat) {
+            match_move(c->match, req);
+        } else {
+            // 자기 차례가 아닐 때(예: 시간 초과로 pass 된 뒤 도착한 수) 온 메시지는 쌓아 두지 않고
+            // 보낸 쪽에만 알려 주고 버린다. 다음 차례에 옛 수가 적용되는 일이 없도록
+            send_reason(c, "invalid_move",
+                        c->state == CONN_PLAYING ? "not your turn" : "game not started");
+        }
+        cJSON_Delete(req);
+    }
+}
+
+static void handle_register(Conn *c, const cJSON *req) {
+    reg_remove(c);           // ack 면 lobby 로, nack 이면 닫힌다
+    /* type 과 username 필드 검사 */
+    cJSON *jtype = cJSON_GetObjectItem(req, "type");
+    cJSON *juser = cJSON_GetObjectItem(req, "username");
+    cJSON *resp = cJSON_CreateObject();
+    int ok = 0;
+
+    if (jtype && jtype->valuestring
+        && strcmp(jtype->valuestring, "register") == 0
+        && juser && juser->valuestring)
+    {
+        /* 중복 검사: lobby 와 진행 중인 판 전체 */
+        int dup = 0;
+        for (int i = 0; i < MAX_CONNS; i++) {
+            const Conn *o = &conn_pool[i];
+            if ((o->state == CONN_LOBBY || o->state == CONN_PLAYING) &&
+                strcmp(o->username, juser->valuestring) == 0)
+            {
+                dup = 1;  break;
             }
         }
-        else {
-            resp = cJSON_CreateObject();
+
+        if (dup) {
+            /* 이미 존재하는 사용자 이름 */
             cJSON_AddStringToObject(resp, "type", "register_nack");
-            cJSON_AddStringToObject(resp, "reason", "invalid register");
+            cJSON_AddStringToObject(resp, "reason", "username exists");
+        }
+        else {
+            /* 정상 등록 */
+            strncpy(c->username, juser->valuestring, sizeof(c->username)-1);
+            c->username[sizeof(c->username)-1] = '\0';
+            cJSON_AddStringToObject(resp, "type", "register_ack");
+            ok = 1;
         }
-        send_to_client(client_fd, resp);
-        cJSON_Delete(resp);
-        cJSON_Delete(req);
     }
-    return 0;
+    else {
+        cJSON_AddStringToObject(resp, "type", "register_nack");
+        cJSON_AddStringToObject(resp, "reason", "invalid register");
+    }
+    send_to_client(c, resp);
+    cJSON_Delete(resp);
+
+    if (ok) lobby_push(c);
+    else conn_finish(c);     // nack 을 다 보낸 뒤에 닫힘
 }
-static void *reject_late_clients(void *arg) {
-    while (1) {
-        sleep(1);
-        if (global_listen_fd < 0) break; // server stopped
-        struct sockaddr_storage addr;
-        socklen_t addrlen = sizeof(addr);
-        int client_fd = accept(global_listen_fd, (struct sockaddr*)&addr, &addrlen);
-        if (client_fd < 0) continue; // no new clients
-        cJSON *nack = cJSON_CreateObject();
-        cJSON_AddStringToObject(nack, "type", "register_nack");
-        cJSON_AddStringToObject(nack, "reason", "game is already running");
-        send_to_client(client_fd, nack);
-        cJSON_Delete(nack);
-        close(client_fd);
-    }
-    return NULL;
+
+// -----------------------------------------------------------------------------
+//  register 대기열: REGISTER_TIMEOUT 이 같으므로 FIFO 의 앞이 가장 먼저 만료된다
+// -----------------------------------------------------------------------------
+static void reg_push(Conn *c) {
+    c->next = NULL;
+    if (reg_tail) reg_tail->next = c;
+    else reg_head = c;
+    reg_tail = c;
+}
+
+static void reg_remove(Conn *c) {
+    Conn **pp = &reg_head, *prev = NULL;
+    while (*pp && *pp != c) { prev = *pp; pp = &(*pp)->next; }
+    if (!*pp) return;
+    *pp = c->next;
+    if (reg_tail == c) reg_tail = prev;
+}
+
+// 접속만 하고 register 를 안 보내는 클라이언트가 pool 을 잡고 있지 않도록
+static void reg_expire(double now) {
+    while (reg_head && reg_head->deadline <= now) {
+        Conn *c = reg_head;
+        reg_remove(c);
+        send_reason(c, "register_nack", "register timeout");
+        conn_finish(c);
+    }
+}
+
+// -----------------------------------------------------------------------------
+//  lobby: 먼저 온 사람이 R
+// -----------------------------------------------------------------------------
+static void lobby_push(Conn *c) {
+    c->state = CONN_LOBBY;
+    c->next = NULL;
+    if (lobby_tail) lobby_tail->next = c;
+    else lobby_head = c;
+    lobby_tail = c;
+
+    if (lobby_head != lobby_tail) {
+        Conn *red = lobby_head, *blue = red->next;
+        lobby_head = blue->next;
+        if (!lobby_head) lobby_tail = NULL;
+        match_start(red, blue);
+    }
 }
-static void game_loop(void) {
 
- 
-    int countPass = 0;
+static void lobby_remove(Conn *c) {
+    Conn **pp = &lobby_head, *prev = NULL;
+    while (*pp && *pp != c) { prev = *pp; pp = &(*pp)->next; }
+    if (!*pp) return;
+    *pp = c->next;
+    if (lobby_tail == c) lobby_tail = prev;
+}
+
+// -----------------------------------------------------------------------------
+//  판 진행: 한 판짜리 game_loop 를 이벤트 단위로 나눈 것
+// -----------------------------------------------------------------------------
+static void match_start(Conn *red, Conn *blue) {
+    Match *m = (Match *)calloc(1, sizeof(Match));
+    if (!m) {
+        perror("calloc");
+        conn_close(red);
+        conn_close(blue);
+        return;
+    }
+    init_game(&m->game);
+    Conn *seats[MAX_CLIENTS] = { red, blue };
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        Conn *c = seats[i];
+        c->state = CONN_PLAYING;
+        c->match = m;
+        c->seat = i;
+        m->conns[i] = c;
+        m->game.players[i].socket = c->fd;
+        memcpy(m->game.players[i].username, c->username, sizeof(c->username));
+        m->game.players[i].registered = 1;
+    }
+    m->next = matches;
+    if (matches) matches->prev = m;
+    matches = m;
+    n_matches++;
+    printf("Match started: %s vs %s (%d running)\n", red->username, blue->username, n_matches);
 
     // --- game_start 메시지  ---
     cJSON *game_start = cJSON_CreateObject();
     cJSON_AddStringToObject(game_start, "type", "game_start");
     cJSON *players = cJSON_AddArrayToObject(game_start, "players");
-    cJSON_AddItemToArray(players, cJSON_CreateString(game.players[0].username));
-    cJSON_AddItemToArray(players, cJSON_CreateString(game.players[1].username));
-    cJSON_AddStringToObject(game_start, "first_player", game.players[0].username);
-    broadcast_json(game_start);
+    cJSON_AddItemToArray(players, cJSON_CreateString(m->game.players[0].username));
+    cJSON_AddItemToArray(players, cJSON_CreateString(m->game.players[1].username));
+    cJSON_AddStringToObject(game_start, "first_player", m->game.players[0].username);
+    broadcast_json(m, game_start);
     cJSON_Delete(game_start);
 
-    int turn = 0; // 0: Red, 1: Black
-
-    while (!isGameOver(game.board)) {
-        // 1) your_turn 메시지 전송 
-        cJSON *your_turn = cJSON_CreateObject();
-        cJSON_AddStringToObject(your_turn, "type", "your_turn");
-        cJSON_AddItemToObject(your_turn, "board", board_to_json(&game));
-        cJSON_AddNumberToObject(your_turn, "timeout", TIMEOUT);
-        send_to_client(game.players[turn].socket, your_turn);
-        cJSON_Delete(your_turn);
-
-        // 2) 소켓이 읽기 가능한지 select()로 감시
-        int client_fd = game.players[turn].socket;
-        fd_set readfds;
-        FD_ZERO(&readfds);
-        FD_SET(client_fd, &readfds);
-
-        struct timeval tv;
-        tv.tv_sec = TIMEOUT;     
-        tv.tv_usec = 0;
-
-        int sel = select(client_fd + 1, &readfds, NULL, NULL, &tv);
-
-        // select() 리턴 처리
-        if (sel < 0) {
-            perror("select");
-            break;
-        }
+    match_prompt(m);
+}
 
-        if (sel == 0) {
-            // 타임아웃 발생
-            cJSON *resp = cJSON_CreateObject();
-            countPass++;
-            cJSON_AddStringToObject(resp, "type", "pass");
-            cJSON_AddItemToObject(resp, "board", board_to_json(&game));
-            // 다음 플레이어로 턴 변경
-            cJSON_AddStringToObject(resp, "next_player", game.players[1 - turn].username);
-            broadcast_json(resp);
-            cJSON_Delete(resp);
+// your_turn 전송 + 타이머 시작, 이미 끝난 판이면 game_over
+static void match_prompt(Match *m) {
+    if (bb_is_game_over(&m->game.bb)) {
+        match_end(m);
+        return;
+    }
+    int turn = m->game.current_turn;
+    cJSON *your_turn = cJSON_CreateObject();
+    cJSON_AddStringToObject(your_turn, "type", "your_turn");
+    cJSON_AddItemToObject(your_turn, "board", board_to_json(&m->game));
+    cJSON_AddNumberToObject(your_turn, "timeout", TIMEOUT);
+    if (m->conns[turn]) send_to_client(m->conns[turn], your_turn);
+    cJSON_Delete(your_turn);
+    m->deadline = now_sec() + TIMEOUT;
+}
 
-            if (countPass == 2) {
-                // 양쪽 다 pass → 게임 종료
-                break;
-            }
-            if (isGameOver(game.board)) {
-                break;
-            }
-            turn = 1 - turn;
-            continue;
-        }
+// 타임아웃 또는 둘 곳이 없어서 보낸 pass
+static void match_pass(Match *m) {
+    int turn = m->game.current_turn;
+    cJSON *resp = cJSON_CreateObject();
+    m->count_pass++;
+    bb_pass(&m->game.bb);
+    cJSON_AddStringToObject(resp, "type", "pass");
+    cJSON_AddItemToObject(resp, "board", board_to_json(&m->game));
+    // 다음 플레이어로 턴 변경
+    cJSON_AddStringToObject(resp, "next_player", m->game.players[1 - turn].username);
+    broadcast_json(m, resp);
+    cJSON_Delete(resp);
+
+    if (m->count_pass == 2 || bb_is_game_over(&m->game.bb)) {
+        // 양쪽 다 pass → 게임 종료
+        match_end(m);
+        return;
+    }
+    m->game.current_turn = 1 - turn;
+    match_prompt(m);
+}
 
-        // sel > 0이면 읽을 데이터가 들어옴 → recv_json 호출
-        cJSON *req = recv_json(client_fd);
-        if (!req) {
-            break;
-        }
+static void match_move(Match *m, const cJSON *req) {
+    GameState *game = &m->game;
+    int turn = game->current_turn;
+    cJSON *jtype = cJSON_GetObjectItem(req, "type");
+    if (!jtype || !jtype->valuestring || strcmp(jtype->valuestring, "move") != 0) {
+        // move가 아닌 경우 무시하고 다시 your_turn
+        match_prompt(m);
+        return;
+    }
 
-        cJSON *jtype = cJSON_GetObjectItem(req, "type");
-        cJSON *resp = cJSON_CreateObject();
-
-        if (jtype && strcmp(jtype->valuestring, "move") == 0) {
-            countPass = 0;  
-            int r1 = cJSON_GetObjectItem(req, "sx")->valueint - 1;
-            int c1 = cJSON_GetObjectItem(req, "sy")->valueint - 1;
-            int r2 = cJSON_GetObjectItem(req, "tx")->valueint - 1;
-            int c2 = cJSON_GetObjectItem(req, "ty")->valueint - 1;
-
-            // 만약 (0,0,0,0)이 넘어오면 “진짜 pass”가 아닌, “move 좌표가 유효하지 않을 때”로 간주
-            if (r1 == -1 && c1 == -1 && r2 == -1 && c2 == -1) {
-                // 클라이언트가 좌표를 모두 0으로 보내 pass 하지만 이 때, 실제로 놓을 수 있는 move가 존재하면 invalid_move
-                if (hasValidMove(game.board, game.players[turn].color)) {
-                    cJSON_AddStringToObject(resp, "type", "invalid_move");
-                } else {
-                    // 패스가 가능한 상황
-                    countPass++;
-                    cJSON_AddStringToObject(resp, "type", "pass");
-                    cJSON_AddItemToObject(resp, "board", board_to_json(&game));
-                    cJSON_AddStringToObject(resp, "next_player", game.players[1 - turn].username);
-                    broadcast_json(resp);
-                    cJSON_Delete(resp);
-                    cJSON_Delete(req);
-
-                    if (countPass == 2) {
-                        // 양쪽 다 pass → 게임 종료
-                        break;
-                    }
-                    if (isGameOver(game.board)) {
-                        break;
-                    }
-                    turn = 1 - turn;
-                    
-                    continue;
-                }
-            }
-            else if (isValidInput(game.board, r1, c1, r2, c2) &&
-                     isValidMove(game.board, game.players[turn].color, r1, c1, r2, c2)) {
-                // 실제로 유효한 move라면
-                Move(game.board, turn, r1, c1, r2, c2);
-                cJSON_AddStringToObject(resp, "type", "move_ok");
-                turn = 1 - turn;
-            } else {
-                // 올바르지 않다면 invalid_move
-                cJSON_AddStringToObject(resp, "type", "invalid_move");
-            }
-        }
-        else {
-            // move가 아닌 경우 무시하고 다음 턴
+    cJSON *resp = cJSON_CreateObject();
+    m->count_pass = 0;
+    cJSON *jsx = cJSON_GetObjectItem(req, "sx"), *jsy = cJSON_GetObjectItem(req, "sy");
+    cJSON *jtx = cJSON_GetObjectItem(req, "tx"), *jty = cJSON_GetObjectItem(req, "ty");
+    int r1 = jsx ? jsx->valueint - 1 : -2;
+    int c1 = jsy ? jsy->valueint - 1 : -2;
+    int r2 = jtx ? jtx->valueint - 1 : -2;
+    int c2 = jty ? jty->valueint - 1 : -2;
+
+    // 만약 (0,0,0,0)이 넘어오면 “진짜 pass”가 아닌, “move 좌표가 유효하지 않을 때”로 간주
+    if (r1 == -1 && c1 == -1 && r2 == -1 && c2 == -1) {
+        // 클라이언트가 좌표를 모두 0으로 보내 pass 하지만 이 때, 실제로 놓을 수 있는 move가 존재하면 invalid_move
+        MoveList legal;
+        if (generate_moves(&game->bb, game->players[turn].color, &legal) > 0) {
+            cJSON_AddStringToObject(resp, "type", "invalid_move");
+        } else {
+            // 패스가 가능한 상황
             cJSON_Delete(resp);
-            cJSON_Delete(req);
-            continue;
+            match_pass(m);
+            return;
         }
-
-        // move_ok 또는 invalid_move 일 때 board와 next_player 필드를 추가하여 브로드캐스트
-        cJSON_AddItemToObject(resp, "board", board_to_json(&game));
-        cJSON_AddStringToObject(resp, "next_player", game.players[1 - turn].username);
-        broadcast_json(resp);
-        cJSON_Delete(resp);
-        cJSON_Delete(req);
     }
+    else if (isValidInput(game->board, r1, c1, r2, c2) &&
+             bb_is_legal_move(&game->bb, game->players[turn].color,
+                              BB_SQ(r1, c1), BB_SQ(r2, c2))) {
+        // 실제로 유효한 move라면 (clone/jump 거리까지 확인)
+        bb_move(&game->bb, game->players[turn].color, BB_SQ(r1, c1), BB_SQ(r2, c2));
+        bb_to_board(&game->bb, game->board);
+        cJSON_AddStringToObject(resp, "type", "move_ok");
+        turn = 1 - turn;
+        game->current_turn = turn;
+    } else {
+        // 올바르지 않다면 invalid_move
+        cJSON_AddStringToObject(resp, "type", "invalid_move");
+    }
+
+    // move_ok 또는 invalid_move 일 때 board와 next_player 필드를 추가하여 브로드캐스트
+    cJSON_AddItemToObject(resp, "board", board_to_json(game));
+    cJSON_AddStringToObject(resp, "next_player", game->players[1 - turn].username);
+    broadcast_json(m, resp);
+    cJSON_Delete(resp);
+    match_prompt(m);
+}
 
-    // Game over 처리 
+// game_over 를 보내고 판을 정리한다. 남은 접속도 닫는다 (한 판 = 한 접속)
+static void match_end(Match *m) {
+    GameState *game = &m->game;
     cJSON *over = cJSON_CreateObject();
     cJSON_AddStringToObject(over, "type", "game_over");
-    cJSON *final_board = board_to_json(&game);
+    cJSON *final_board = board_to_json(game);
     cJSON_AddItemToObject(over, "board", final_board);
     cJSON *scores = cJSON_CreateObject();
-    cJSON_AddNumberToObject(scores, game.players[0].username,
-                            countR(game.board));
-    cJSON_AddNumberToObject(scores, game.players[1].username,
-                            countB(game.board));
+    cJSON_AddNumberToObject(scores, game->players[0].username,
+                            game->bb.n_red);
+    cJSON_AddNumberToObject(scores, game->players[1].username,
+                            game->bb.n_blue);
     cJSON_AddItemToObject(over, "scores", scores);
-    broadcast_json(over);
+    broadcast_json(m, over);
     cJSON_Delete(over);
+
+    if (m->prev) m->prev->next = m->next;
+    else matches = m->next;
+    if (m->next) m->next->prev = m->prev;
+    n_matches--;
+    printf("Match over: %s %d - %d %s (%d running)\n", game->players[0].username, game->bb.n_red,
+           game->bb.n_blue, game->players[1].username, n_matches);
+
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+        Conn *c = m->conns[i];
+        if (!c) continue;
+        m->conns[i] = NULL;
+        c->match = NULL;
+        conn_finish(c);
+    }
+    free(m);
 }
 
 int server_run(const char *port) {
@@ -342,21 +671,74 @@ int server_run(const char *port) {
         fprintf(stderr, "Failed to create listen socket on port %s\n", port);
         return EXIT_FAILURE;
     }
+    epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0) {
+        perror("epoll_create1");
+        close(listen_fd);
+        return EXIT_FAILURE;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;          // NULL == listen socket
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+
+    for (int i = MAX_CONNS - 1; i >= 0; i--) {
+        conn_pool[i].next = free_conns;
+        free_conns = &conn_pool[i];
+    }
+    // 끊긴 상대에게 쓰다가 SIGPIPE 로 서버 전체가 죽지 않도록
+    signal(SIGPIPE, SIG_IGN);
     printf("Server started on port %s\n", port);
-    global_listen_fd = listen_fd;
-    init_game(&game);
-    accept_and_register(listen_fd);
-    pthread_t reject_thread;
-    pthread_create(&reject_thread, NULL, reject_late_clients, NULL);
-    game_loop();
 
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (game.players[i].socket >= 0) {
-            close(game.players[i].socket);
+    struct epoll_event events[MAX_EVENTS];
+    while (1) {
+        // 가장 가까운 턴 제한 시각까지만 기다린다
+        double now = now_sec(), wake = reg_head ? reg_head->deadline : -1.0;
+        for (Match *m = matches; m; m = m->next)
+            if (wake < 0.0 || m->deadline < wake) wake = m->deadline;
+        int timeout_ms = wake < 0.0 ? -1 : wake <= now ? 0 : (int)((wake - now) * 1000.0) + 1;
+
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout_ms);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            Conn *c = (Conn *)events[i].data.ptr;
+            if (!c) {
+                accept_clients(listen_fd);
+                continue;
+            }
+            if (c->state == CONN_CLOSED) continue;
+            uint32_t ev_mask = events[i].events;
+            if (ev_mask & EPOLLOUT) conn_flush(c);
+            if (c->state == CONN_CLOSED) continue;
+            if ((ev_mask & EPOLLIN) && c->state != CONN_DRAINING) conn_read(c);
+            else if (ev_mask & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) conn_close(c);
+        }
+
+        // 시간 안에 수를 못 보낸 차례는 pass 처리, register 를 안 보낸 접속은 끊는다
+        now = now_sec();
+        reg_expire(now);
+        for (Match *m = matches, *next; m; m = next) {
+            next = m->next;      // match_pass 가 판을 끝내면 m 은 해제된다
+            if (m->deadline <= now) match_pass(m);
+        }
+
+        while (closed_conns) {
+            Conn *c = closed_conns;
+            closed_conns = c->next;
+            json_reader_free(&c->in);
+            c->state = CONN_FREE;
+            c->next = free_conns;
+            free_conns = c;
         }
     }
+
+    json_encoder_free(&encoder);
+    close(epoll_fd);
     close(listen_fd);
-    global_listen_fd = -1; 
     printf("Server stopped.\n");
     return EXIT_SUCCESS;
 }
@@ -4,9 +4,11 @@
 #include <stdio.h>
 #include <stdint.h>
 #include "../libs/cJSON.h"
+#include "bitboard.h"
 
 #define BOARD_SIZE 8
-#define MAX_CLIENTS 2
+#define MAX_CLIENTS 2        // 한 판의 플레이어 수
+#define MAX_CONNS   1024     // 서버 전체 동시 접속 (lobby + 진행 중인 판)
 #define TIMEOUT 5
 
 typedef struct {
@@ -20,6 +22,7 @@ typedef struct {
     Player players[MAX_CLIENTS];
     int current_turn; 
     char board[BOARD_SIZE][BOARD_SIZE];
+    BitBoard bb;      // board 와 항상 동기화, 돌/빈칸 카운터 포함
 } GameState;
 
 void init_game_state(GameState *game);
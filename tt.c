@@ -0,0 +1,131 @@
+#include "../include/tt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+static TTBucket *table = NULL;
+static size_t table_bytes = 0;
+static uint64_t bucket_mask = 0;
+static int table_mmapped = 0;
+static uint8_t tt_age = 0;
+
+#define TT_AGE_MASK 63
+
+// 여러 탐색 스레드가 잠금 없이 공유: 8바이트 단위 relaxed load/store 만 쓰고
+// check ^ data 검사로 다른 스레드와 섞인 entry 를 버린다
+static inline uint64_t load64(const uint64_t *p)   { return __atomic_load_n(p, __ATOMIC_RELAXED); }
+static inline void store64(uint64_t *p, uint64_t v) { __atomic_store_n(p, v, __ATOMIC_RELAXED); }
+
+static inline uint64_t pack(int score, PackedMove move, int depth, int bound, int age) {
+    return (uint64_t)(uint32_t)score
+         | (uint64_t)move << 32
+         | (uint64_t)(uint8_t)depth << 48
+         | (uint64_t)(bound & 3) << 56
+         | (uint64_t)(age & TT_AGE_MASK) << 58;
+}
+static inline int data_score(uint64_t d) { return (int32_t)(uint32_t)d; }
+static inline PackedMove data_move(uint64_t d) { return (PackedMove)(d >> 32); }
+static inline int data_depth(uint64_t d) { return (uint8_t)(d >> 48); }
+static inline int data_bound(uint64_t d) { return (d >> 56) & 3; }
+static inline int data_age(uint64_t d)   { return (d >> 58) & TT_AGE_MASK; }
+
+/*
+ * mb 메가바이트 이하에서 가장 큰 2의 거듭제곱 개수의 bucket 할당.
+ * huge_pages 면 MAP_HUGETLB 를 먼저 시도하고, 실패하면 일반 mmap + THP 힌트.
+ */
+int tt_init(size_t mb, int huge_pages) {
+    tt_free();
+    size_t want = (mb ? mb : 1) << 20;
+    size_t buckets = 1;
+    while (buckets * 2 * sizeof(TTBucket) <= want) buckets *= 2;
+    size_t bytes = buckets * sizeof(TTBucket);
+
+    void *mem = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (huge_pages)
+        mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (mem == MAP_FAILED) {
+        mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            perror("mmap");
+            return -1;
+        }
+#ifdef MADV_HUGEPAGE
+        if (huge_pages) madvise(mem, bytes, MADV_HUGEPAGE);
+#endif
+    }
+    table = (TTBucket *)mem;   // mmap 은 0 으로 채워진 페이지를 준다
+    table_bytes = bytes;
+    table_mmapped = 1;
+    bucket_mask = buckets - 1;
+    tt_age = 0;
+    return 0;
+}
+
+void tt_free(void) {
+    if (table && table_mmapped) munmap(table, table_bytes);
+    table = NULL;
+    table_bytes = 0;
+    table_mmapped = 0;
+    bucket_mask = 0;
+}
+
+void tt_clear(void) {
+    if (table) memset(table, 0, table_bytes);
+}
+
+// 턴마다 호출: 이전 턴 entry 를 먼저 교체 대상으로
+void tt_new_search(void) {
+    tt_age = (tt_age + 1) & TT_AGE_MASK;
+}
+
+int tt_probe(uint64_t key, TTHit *hit) {
+    if (!table) return 0;
+    TTBucket *b = &table[key & bucket_mask];
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        uint64_t data = load64(&b->entry[i].data);
+        uint64_t check = load64(&b->entry[i].check);
+        if ((check ^ data) != key || data_bound(data) == TT_NONE) continue;
+        hit->score = data_score(data);
+        hit->depth = data_depth(data);
+        hit->bound = data_bound(data);
+        hit->move  = data_move(data);
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * 같은 키가 있으면 그 자리에 (더 얕은 결과면 best move 만 보존하고 건너뜀),
+ * 없으면 이전 턴 entry -> 가장 얕은 entry 순으로 교체 (depth-preferred).
+ */
+void tt_store(uint64_t key, int depth, int score, int bound, PackedMove move) {
+    if (!table) return;
+    TTBucket *b = &table[key & bucket_mask];
+    TTEntry *victim = NULL;
+    int victim_value = 1 << 30;
+
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        TTEntry *e = &b->entry[i];
+        uint64_t data = load64(&e->data);
+        if ((load64(&e->check) ^ data) == key && data_bound(data) != TT_NONE) {
+            if (depth < data_depth(data) && bound != TT_EXACT && data_age(data) == tt_age)
+                return;
+            if (move == MV_NONE) move = data_move(data);
+            victim = e;
+            break;
+        }
+        int value = data_bound(data) == TT_NONE ? -1
+                  : data_depth(data) + (data_age(data) == tt_age ? 256 : 0);
+        if (value < victim_value) {
+            victim_value = value;
+            victim = e;
+        }
+    }
+    uint64_t data = pack(score, move, depth, bound, tt_age);
+    store64(&victim->data, data);
+    store64(&victim->check, key ^ data);
+}
@@ -0,0 +1,40 @@
+#ifndef TT_H
+#define TT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game.h"
+
+#define TT_DEFAULT_MB   64
+#define TT_BUCKET_SIZE  4            // 16B entry x 4 = 64B (캐시 라인 1개)
+
+enum { TT_NONE = 0, TT_EXACT = 1, TT_LOWER = 2, TT_UPPER = 3 };
+
+/*
+ * data 비트 배치: score(32) | move(16) << 32 | depth(8) << 48 | bound(2) << 56 | age(6) << 58
+ * check = key ^ data 로 저장해 두면, 읽을 때 (check ^ data) == key 로 찢어진 쓰기를 걸러낼 수 있다.
+ */
+typedef struct {
+    uint64_t check;
+    uint64_t data;
+} TTEntry;
+
+typedef struct {
+    TTEntry entry[TT_BUCKET_SIZE];
+} __attribute__((aligned(64))) TTBucket;
+
+typedef struct {
+    int score;
+    int depth;
+    int bound;
+    PackedMove move;
+} TTHit;
+
+int tt_init(size_t mb, int huge_pages);
+void tt_free(void);
+void tt_clear(void);
+void tt_new_search(void);
+int tt_probe(uint64_t key, TTHit *hit);
+void tt_store(uint64_t key, int depth, int score, int bound, PackedMove move);
+
+#endif
@@ -0,0 +1,74 @@
+#include "../include/tunedata.h"
+#include "../include/search.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_PLIES  1000
+
+static int mobility(const BitBoard *bb, char me) {
+    uint64_t own = bb_own(bb, me), opp = bb_opp(bb, me), empty = bb_empty(bb);
+    return bb_popcount((bb_adjacent(own) | bb_jump_targets(own)) & empty)
+         - bb_popcount((bb_adjacent(opp) | bb_jump_targets(opp)) & empty);
+}
+
+static void push_sample(TuneSet *set, const BitBoard *bb) {
+    if (set->count == set->cap) {
+        set->cap = set->cap ? set->cap * 2 : 65536;
+        set->samples = (TuneSample *)realloc(set->samples, set->cap * sizeof(TuneSample));
+        if (!set->samples) { perror("realloc"); exit(EXIT_FAILURE); }
+    }
+    set->samples[set->count].bb = *bb;
+    set->samples[set->count].target = 0;
+    set->count++;
+}
+
+/*
+ * 한 수에 최대 8 개가 뒤집혀서 종국 결과는 초중반 국면과 상관이 거의 없다 (horizon 0 = 종국).
+ * depth 3 self-play 기준 horizon 1 이 가장 강했다.
+ */
+void tune_play_game(TuneSet *set, uint64_t *rng, int depth, int random_plies, int epsilon, int horizon) {
+    char board[BOARD_SIZE][BOARD_SIZE];
+    init_board(board);
+    BitBoard bb;
+    bb_from_board(&bb, board);
+    bb_set_side(&bb, 'R');
+    size_t first = set->count;
+
+    int passes = 0;
+    for (int ply = 0; ply < MAX_PLIES && !bb_is_game_over(&bb); ply++) {
+        char me = bb_side(&bb);
+        MoveList list;
+        if (generate_moves(&bb, me, &list) == 0) {
+            bb_pass(&bb);
+            if (++passes == 2) break;
+            continue;
+        }
+        passes = 0;
+        if (ply >= random_plies) push_sample(set, &bb);
+
+        PackedMove mv;
+        if (ply < random_plies || (int)(next_rand(rng) % 100) < epsilon) {
+            mv = list.moves[next_rand(rng) % (uint64_t)list.count];
+        } else {
+            SearchLimits limits = { search_now() + 10.0, depth, NULL, 0 };
+            SearchResult res;
+            search_root(&bb, me, &limits, &res);
+            mv = res.best;
+        }
+        bb_move(&bb, me, MV_FROM(mv), MV_TO(mv));
+    }
+
+    for (size_t i = first; i < set->count; i++) {
+        TuneSample *s = &set->samples[i];
+        const BitBoard *later = (horizon > 0 && i + horizon < set->count) ? &set->samples[i + horizon].bb : &bb;
+        int red_diff = (int)later->n_red - (int)later->n_blue;
+        char me = bb_side(&s->bb);
+        s->target = 16 * (me == 'R' ? red_diff : -red_diff) - mobility(&s->bb, me);
+    }
+}
+
+void tune_set_free(TuneSet *set) {
+    free(set->samples);
+    set->samples = NULL;
+    set->count = set->cap = 0;
+}
@@ -0,0 +1,36 @@
+#ifndef TUNEDATA_H
+#define TUNEDATA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game.h"
+
+/*
+ * 평가 함수 학습용 self-play 데이터 (patterntune, nnuetrain 공용).
+ * 얕은 alpha-beta 끼리 두면서 초반 random_plies 와 epsilon% 확률로 무작위 수를 섞고,
+ * 각 국면에 target = 둘 차례 기준 horizon 수 뒤(0 이면 종국) 돌 차이 x 16 - mobility 항.
+ * 단위는 search.c evaluate 와 같다 (돌 하나 = 16).
+ */
+typedef struct {
+    BitBoard bb;
+    int target;
+} TuneSample;
+
+typedef struct {
+    TuneSample *samples;
+    size_t count, cap;
+} TuneSet;
+
+// xorshift64* (selfplay, 학습 도구 공용). s 는 0 이 아니어야 한다
+static inline uint64_t next_rand(uint64_t *s) {
+    uint64_t x = *s;
+    x ^= x >> 12; x ^= x << 25; x ^= x >> 27;
+    *s = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// search_set_eval 로 정한 평가 함수로 한 판 두고 국면들을 set 에 덧붙인다
+void tune_play_game(TuneSet *set, uint64_t *rng, int depth, int random_plies, int epsilon, int horizon);
+void tune_set_free(TuneSet *set);
+
+#endif